@@ -0,0 +1,31 @@
+#ifndef EXAMPLES_COUNTING_ALLOCATOR_H
+#define EXAMPLES_COUNTING_ALLOCATOR_H
+
+// Replaces the global allocation functions with ones that count heap
+// allocations in g_allocations, for the benchmarks that report allocations
+// per operation. Every form of operator new is paired with the matching
+// operator delete so that GCC's -Wmismatched-new-delete stays quiet.
+// Replacements cannot be inline: include this from exactly one translation
+// unit of an executable.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> g_allocations{0};
+
+static void* counted_malloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size) { return counted_malloc(size); }
+void* operator new[](size_t size) { return counted_malloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+#endif // EXAMPLES_COUNTING_ALLOCATOR_H
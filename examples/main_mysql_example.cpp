@@ -1,4 +1,5 @@
 #include "mysql_parser/mysql_parser.h" // Ensure this path is correct for your include setup
+#include "mysql_parser/mysql_ast_print.h" // For MysqlParser::print_ast
 #include <iostream>
 #include <vector>
 #include <string>
@@ -56,6 +57,8 @@ int main() {
         // SELECT with WHERE
         "SELECT product_name, price FROM products WHERE category = 'Electronics';",
         "SELECT * FROM employees WHERE salary > 50000 AND department_id = 3;",
+        "SELECT * FROM t WHERE a = 1 AND b = 2;", // Comparisons bind tighter than AND
+        "SELECT id FROM users WHERE x IN (1, 2, 3) AND y NOT IN ('a', 'b');", // [NOT] IN lists
 
         // SELECT with ORDER BY
         "SELECT student_name, score FROM results ORDER BY score DESC;",
@@ -64,6 +67,7 @@ int main() {
         // SELECT with LIMIT
         "SELECT event_name FROM event_log LIMIT 10;",
         "SELECT message FROM messages ORDER BY created_at DESC LIMIT 5, 10;", // LIMIT offset, count
+        "SELECT message FROM messages ORDER BY created_at DESC LIMIT 10 OFFSET 5;", // LIMIT count OFFSET offset
 
         // SELECT with GROUP BY
         "SELECT department, COUNT(*) AS num_employees FROM employees GROUP BY department;",
@@ -0,0 +1,129 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_ast_reclaimer.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::NodeType;
+
+// Stand-in for the routing decision a proxy makes before it is done with the tree
+size_t route(const AstNode* ast) {
+    return static_cast<size_t>(ast->type) + ast->children.size();
+}
+
+// Request-path latency of parse + route + release, where release is either an
+// inline ~AstNode or a hand-off to AstReclaimer. The workload is mostly small
+// statements with an occasional wide multi-row INSERT or long argument list,
+// whose teardown is what shows up in the tail.
+// Usage: mysql_ast_reclaimer_benchmark [-i iterations] [-r rows] [-w wide_every]
+int main(int argc, char* argv[]) {
+    size_t iterations = 200000;
+    size_t rows = 500;
+    size_t wide_every = 20;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoul(argv[++i]);
+        } else if (arg == "-r" && i + 1 < argc) {
+            rows = std::stoul(argv[++i]);
+        } else if (arg == "-w" && i + 1 < argc) {
+            wide_every = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    std::vector<std::string> small = {
+        "SELECT id, name FROM users WHERE id = 42;",
+        "SELECT COUNT(*) FROM orders o JOIN users u ON o.user_id = u.id WHERE u.active = 1;",
+        "DELETE FROM sessions WHERE expires < 1700000000;",
+        "SET autocommit = 1;",
+        "SELECT a FROM t ORDER BY a DESC LIMIT 10;"
+    };
+    std::string insert = "INSERT INTO events (id, kind, payload, created) VALUES ";
+    for (size_t r = 0; r < rows; ++r) {
+        if (r) insert += ", ";
+        insert += "(" + std::to_string(r) + ", 'click', 'x-" + std::to_string(r) + "', NOW())";
+    }
+    insert += ";";
+    std::string wide_call = "SELECT COALESCE(0";
+    for (size_t r = 0; r < rows * 4; ++r) wide_call += ", " + std::to_string(r);
+    wide_call += ") FROM t;";
+
+    std::vector<const std::string*> workload;
+    for (size_t i = 0; i < iterations; ++i) {
+        if (i % wide_every == wide_every - 1) {
+            workload.push_back((i / wide_every) % 2 ? &wide_call : &insert);
+        } else {
+            workload.push_back(&small[i % small.size()]);
+        }
+    }
+
+    enum class Mode { Inline, Background, Idle };
+    using clock = std::chrono::steady_clock;
+    MysqlParser::Parser parser;
+
+    auto run = [&](Mode mode, const char* label) {
+        MysqlParser::AstReclaimerOptions options;
+        options.background_thread = (mode == Mode::Background);
+        MysqlParser::AstReclaimer reclaimer(options);
+
+        std::vector<double> latencies, releases;
+        latencies.reserve(workload.size());
+        releases.reserve(workload.size());
+        size_t checksum = 0;
+        for (size_t i = 0; i < workload.size(); ++i) {
+            auto start = clock::now();
+            auto ast = parser.parse(*workload[i]);
+            if (ast) checksum += route(ast.get());
+            auto release_start = clock::now();
+            if (mode == Mode::Inline) {
+                ast.reset();
+            } else {
+                reclaimer.retire(std::move(ast));
+            }
+            auto end = clock::now();
+            latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            releases.push_back(std::chrono::duration<double, std::micro>(end - release_start).count());
+            if (mode == Mode::Idle && i % 64 == 63) {
+                reclaimer.reclaim(); // Between requests, outside the measured latency
+            }
+        }
+        reclaimer.reclaim();
+
+        auto report = [](const char* what, std::vector<double>& v) {
+            std::sort(v.begin(), v.end());
+            auto pct = [&](double p) { return v[std::min(v.size() - 1, static_cast<size_t>(p * v.size()))]; };
+            double sum = 0;
+            for (double l : v) sum += l;
+            std::cout << "    " << std::left << std::setw(9) << what << std::right
+                      << " mean " << std::setw(8) << sum / v.size()
+                      << "  p50 " << std::setw(8) << pct(0.50)
+                      << "  p99 " << std::setw(8) << pct(0.99)
+                      << "  p99.9 " << std::setw(8) << pct(0.999) << " us" << std::endl;
+        };
+        std::cout << label << std::endl;
+        report("request", latencies);
+        report("release", releases);
+        if (mode != Mode::Inline) {
+            MysqlParser::AstReclaimerStats stats = reclaimer.getStats();
+            std::cout << "    retired " << stats.retired << ", reclaimed " << stats.reclaimed
+                      << ", inline " << stats.inline_frees << ", batches " << stats.batches
+                      << ", " << stats.reclaim_ns / 1e6 << " ms freeing, backlog " << stats.backlog << std::endl;
+        }
+        return checksum;
+    };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Requests: " << iterations << ", 1 in " << wide_every << " with " << rows << " rows / "
+              << rows * 4 << " arguments" << std::endl;
+    size_t a = run(Mode::Inline, "Inline delete:");
+    size_t b = run(Mode::Background, "Background reclaimer:");
+    size_t c = run(Mode::Idle, "Idle-point reclaim():");
+    return (a == b && b == c) ? 0 : 1;
+}
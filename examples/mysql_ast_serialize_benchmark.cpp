@@ -0,0 +1,209 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_ast_serialize.h"
+#include "mysql_parser/mysql_bulk_parser.h" // For BulkParser::splitStatements
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using MysqlParser::AstNode;
+using MysqlParser::AstNodeView;
+
+// Compares the cost of getting an AST for a cached statement four ways:
+//   1. re-parsing the SQL text
+//   2. AstSerializer::prepare() + write() (the one-time cost of caching it)
+//   3. deserialize_ast(): validate the blob and materialize an AstNode tree
+//   4. AstBlobView: validate and walk the blob in place, without copying
+// Then writes all blobs to a file, mmaps it read-only and checks that every
+// blob read from the mapping matches the tree it was made from.
+// Usage: mysql_ast_serialize_benchmark [-i iterations] [-f file.sql]
+
+const std::vector<std::string> kDefaultCorpus = {
+    "SELECT name FROM users WHERE id = 42;",
+    "SELECT a, b FROM shop.t3 JOIN t8 ON t3.id = t8.id WHERE t3.x > 10 LIMIT 20;",
+    "SELECT COUNT(*) FROM t42 GROUP BY category HAVING COUNT(*) > 5;",
+    "SELECT dt.c FROM (SELECT c FROM t99 WHERE c > 0) AS dt ORDER BY dt.c DESC;",
+    "SELECT * FROM t5 WHERE k = 'it''s' LIMIT 1 FOR SHARE;",
+    "INSERT INTO t12 (id, v) VALUES (1, 'a'), (2, 'b'), (3, 'c'), (4, 'd');",
+    "DELETE FROM t21 WHERE created < '2020-01-01' LIMIT 1000;",
+    "SET @@session.sql_mode = 'STRICT_ALL_TABLES', @@global.max_connections = 500;",
+    "SET NAMES utf8mb4;",
+    "SHOW DATABASES;"
+};
+
+bool same_tree(const AstNode* a, AstNodeView b) {
+    if (a->type != b.type() || a->value != b.value() || a->escaped != b.escaped() ||
+        a->children.size() != b.childCount()) {
+        return false;
+    }
+    AstNodeView c = b.firstChild();
+    for (const AstNode* child : a->children) {
+        if (!same_tree(child, c)) return false;
+        c = c.nextSibling();
+    }
+    return true;
+}
+
+size_t count_nodes(AstNodeView v) {
+    size_t n = 1;
+    for (AstNodeView c = v.firstChild(); c; c = c.nextSibling()) n += count_nodes(c);
+    return n;
+}
+
+size_t count_nodes(const AstNode* node) {
+    size_t n = 1;
+    for (const AstNode* child : node->children) n += count_nodes(child);
+    return n;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 20000;
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else if (arg == "-f" && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    std::vector<std::string> corpus = kDefaultCorpus;
+    if (!path.empty()) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            std::cerr << "Error: cannot open " << path << std::endl;
+            return 1;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string data = buffer.str();
+        corpus.clear();
+        for (const auto& span : MysqlParser::BulkParser::splitStatements(data.data(), data.size())) {
+            corpus.emplace_back(data, span.offset, span.length);
+        }
+    }
+
+    MysqlParser::Parser parser;
+    MysqlParser::AstSerializer serializer;
+    std::vector<std::string> texts;
+    std::vector<std::unique_ptr<AstNode>> asts;
+    std::vector<std::string> blobs;
+    size_t text_bytes = 0, blob_bytes = 0, nodes = 0;
+    for (const auto& q : corpus) {
+        auto ast = parser.parse(q);
+        parser.clearErrors();
+        if (!ast) continue;
+        texts.push_back(q);
+        blobs.push_back(serializer.serialize(ast.get()));
+        text_bytes += q.size();
+        blob_bytes += blobs.back().size();
+        nodes += count_nodes(ast.get());
+        asts.push_back(std::move(ast));
+    }
+    if (asts.empty()) {
+        std::cerr << "Error: nothing parsed" << std::endl;
+        return 1;
+    }
+    size_t rounds = std::max<size_t>(1, iterations / asts.size());
+    size_t ops = rounds * asts.size();
+
+    using clock = std::chrono::high_resolution_clock;
+    auto per_op_ns = [&](clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count() / ops;
+    };
+    size_t sink = 0;
+
+    auto start = clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (const auto& q : texts) sink += parser.parse(q) != nullptr;
+    }
+    double parse_ns = per_op_ns(start);
+
+    std::vector<char> buffer(1 << 16);
+    start = clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (const auto& ast : asts) {
+            size_t size = serializer.prepare(ast.get());
+            if (size > buffer.size()) buffer.resize(size);
+            sink += serializer.write(buffer.data(), buffer.size());
+        }
+    }
+    double encode_ns = per_op_ns(start);
+
+    start = clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (const auto& blob : blobs) sink += MysqlParser::deserialize_ast(blob.data(), blob.size()) != nullptr;
+    }
+    double decode_ns = per_op_ns(start);
+
+    start = clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (const auto& blob : blobs) {
+            MysqlParser::AstBlobView view(blob.data(), blob.size());
+            sink += count_nodes(view.root());
+        }
+    }
+    double view_ns = per_op_ns(start);
+
+    // Cross-process path: one file of concatenated blobs, read through a read-only mapping
+    char file_name[] = "/tmp/mysql_ast_blobsXXXXXX";
+    int fd = mkstemp(file_name);
+    if (fd < 0) {
+        std::perror("mkstemp");
+        return 1;
+    }
+    unlink(file_name);
+    for (const auto& blob : blobs) {
+        if (::write(fd, blob.data(), blob.size()) != static_cast<ssize_t>(blob.size())) {
+            std::perror("write");
+            return 1;
+        }
+    }
+    void* map = mmap(nullptr, blob_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+    size_t mismatches = 0;
+    const char* p = static_cast<const char*>(map);
+    const char* end = p + blob_bytes;
+    for (const auto& ast : asts) {
+        MysqlParser::AstBlobView view(p, end - p);
+        if (!view.valid()) {
+            std::cerr << "Error: " << view.error() << std::endl;
+            mismatches++;
+            break;
+        }
+        if (!same_tree(ast.get(), view.root())) mismatches++;
+        p += view.size();
+    }
+    munmap(map, blob_bytes);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Statements: " << asts.size() << " (" << nodes << " nodes), SQL " << text_bytes
+              << " bytes, blobs " << blob_bytes << " bytes" << std::endl;
+    std::cout << "Re-parse:                " << parse_ns << " ns/statement" << std::endl;
+    std::cout << "Encode (prepare + write): " << encode_ns << " ns/statement" << std::endl;
+    std::cout << "Decode to AstNode:       " << decode_ns << " ns/statement" << std::endl;
+    std::cout << "Validate + walk view:    " << view_ns << " ns/statement" << std::endl;
+    std::cout << "mmap round trip:         " << (mismatches ? "MISMATCH" : "ok") << std::endl;
+    std::cout << "=======================\n";
+    return (mismatches == 0 && sink > 0) ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "mysql_parser/mysql_bulk_parser.h" // Ensure this path is correct
+#include "mysql_parser/mysql_ast_print.h" // For MysqlParser::print_ast
+#include <iostream>
+#include <string>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+// Parses a SQL dump or query log file with MysqlParser::BulkParser.
+// Usage: mysql_bulk_parser_example <file.sql> [-t threads] [-v]
+int main(int argc, char* argv[]) {
+    std::string path;
+    unsigned threads = 0; // 0 = one per hardware thread
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-t" && i + 1 < argc) {
+            try {
+                threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "Warning: Invalid thread count. Using default." << std::endl;
+                threads = 0;
+            }
+        } else if (arg == "-v") {
+            verbose = true;
+        } else if (path.empty()) {
+            path = arg;
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <file.sql> [-t threads] [-v]" << std::endl;
+        return 1;
+    }
+
+    MysqlParser::BulkParser bulk_parser(threads);
+    long long successful_parses = 0;
+    long long failed_parses = 0;
+    unsigned long long bytes = 0;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    bool ok = bulk_parser.parseFile(path, [&](MysqlParser::BulkParseResult& result) {
+        bytes += result.sql.size();
+        if (result.ast) {
+            successful_parses++;
+        } else {
+            failed_parses++;
+        }
+        if (verbose) {
+            std::cout << "------------------------------------------\n";
+            std::cout << "Statement #" << result.index << ": " << result.sql << std::endl;
+            if (result.ast) {
+                MysqlParser::print_ast(result.ast.get());
+            } else {
+                for (const auto& error : result.errors) {
+                    std::cout << "  Error: " << error << std::endl;
+                }
+            }
+        }
+    });
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    if (!ok) {
+        for (const auto& error : bulk_parser.getErrors()) {
+            std::cerr << "Error: " << error << std::endl;
+        }
+        return 1;
+    }
+
+    std::chrono::duration<double> duration = end_time - start_time;
+    double seconds = duration.count();
+    long long total = successful_parses + failed_parses;
+
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Threads: " << bulk_parser.threadCount() << std::endl;
+    std::cout << "Statements: " << total << std::endl;
+    std::cout << "Successful parses: " << successful_parses << std::endl;
+    std::cout << "Failed parses: " << failed_parses << std::endl;
+    std::cout << "Total parsing time: " << std::fixed << std::setprecision(3) << seconds << " seconds" << std::endl;
+    if (seconds > 0) {
+        std::cout << "Average parsing speed: " << std::fixed << std::setprecision(2) << (total / seconds) << " queries/second, "
+                  << (bytes / seconds / (1024.0 * 1024.0)) << " MiB/second" << std::endl;
+    }
+    std::cout << "=======================\n";
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_digest_stats.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+// Shows which statements share a digest, then compares the cost of recording
+// per-statement stats from many threads: a mutex-protected unordered_map
+// keyed by normalized text versus DigestStatsAggregator keyed by
+// Parser::getDigest(). A collector thread calls snapshotAndReset() throughout
+// the aggregator run, and the collected calls must add up exactly.
+// Usage: mysql_digest_stats_benchmark [-t max_threads] [-n records_per_thread]
+
+// The caller-side normalization the aggregator replaces: literals become '?'
+std::string normalize(const std::string& sql) {
+    std::string out;
+    out.reserve(sql.size());
+    for (size_t i = 0; i < sql.size(); ++i) {
+        char c = sql[i];
+        if (c == '\'' || c == '"') {
+            size_t end = sql.find(c, i + 1);
+            i = end == std::string::npos ? sql.size() : end;
+            out += '?';
+        } else if (c >= '0' && c <= '9' && (out.empty() || !(isalnum(static_cast<unsigned char>(out.back())) || out.back() == '_'))) {
+            while (i + 1 < sql.size() && (isdigit(static_cast<unsigned char>(sql[i + 1])) || sql[i + 1] == '.')) ++i;
+            out += '?';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+struct MapStats {
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+};
+
+int main(int argc, char* argv[]) {
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t per_thread = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-t" && i + 1 < argc) {
+            max_threads = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "-n" && i + 1 < argc) {
+            per_thread = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    MysqlParser::Parser parser;
+    const std::vector<std::string> same_shape = {
+        "INSERT INTO users (id, name) VALUES (1, 'ann');",
+        "insert into users (id, name) values (2, 'bob')",
+        "INSERT /* from the API */ INTO users (id, name) VALUES (4, 'dee', 5);",
+        "INSERT INTO users (id, email) VALUES (1, 'ann');"
+    };
+    std::cout << "Digests:" << std::endl;
+    for (const auto& q : same_shape) {
+        auto ast = parser.parse(q);
+        std::cout << "  " << std::hex << std::setw(16) << std::setfill('0') << parser.getDigest() << std::dec
+                  << std::setfill(' ') << "  " << q << std::endl;
+    }
+
+    // Workload: parsed once up front, since parsing costs the same either way
+    std::vector<std::string> queries;
+    for (int i = 0; i < 256; ++i) {
+        std::string n = std::to_string(i);
+        queries.push_back("SELECT a, b FROM t" + std::to_string(i % 64) + " WHERE id = " + n + ";");
+        queries.push_back("INSERT INTO log" + std::to_string(i % 32) + " (k, v) VALUES (" + n + ", 'v" + n + "');");
+        queries.push_back("DELETE FROM q" + std::to_string(i % 16) + " WHERE id = " + n + " LIMIT 5;");
+        queries.push_back("SELECT COALESCE(a, " + n + ", 'x" + n + "') FROM t" + std::to_string(i % 64) + " ORDER BY b LIMIT " + n + ";");
+    }
+    std::vector<uint64_t> digests;
+    std::vector<std::string> normalized;
+    for (const auto& q : queries) {
+        auto ast = parser.parse(q);
+        digests.push_back(parser.getDigest());
+        normalized.push_back(normalize(q));
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto run_threads = [&](size_t threads, auto&& body) {
+        std::vector<std::thread> workers;
+        auto start = clock::now();
+        for (size_t t = 0; t < threads; ++t) workers.emplace_back(body, t);
+        for (auto& w : workers) w.join();
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    };
+
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    bool exact = true;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "threads   mutex+map ns/record   aggregator ns/record   collections" << std::endl;
+    for (size_t threads : thread_counts) {
+        std::mutex mutex;
+        std::unordered_map<std::string, MapStats> map;
+        double map_ns = run_threads(threads, [&](size_t t) {
+            for (size_t i = 0; i < per_thread; ++i) {
+                size_t k = (i * 7 + t * 13) % queries.size();
+                std::lock_guard<std::mutex> lock(mutex);
+                MapStats& s = map[normalized[k]];
+                s.calls++;
+                s.total_ns += i & 1023;
+            }
+        });
+
+        MysqlParser::DigestStatsAggregator stats;
+        std::atomic<bool> done{false};
+        uint64_t collected = 0;
+        size_t collections = 0;
+        std::thread collector([&] {
+            while (!done.load()) {
+                for (const auto& d : stats.snapshotAndReset().digests) collected += d.calls;
+                ++collections;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        double agg_ns = run_threads(threads, [&](size_t t) {
+            for (size_t i = 0; i < per_thread; ++i) {
+                size_t k = (i * 7 + t * 13) % queries.size();
+                stats.record(digests[k], i & 1023, 0, false, queries[k]);
+            }
+        });
+        done = true;
+        collector.join();
+        MysqlParser::DigestStatsSnapshot last = stats.snapshotAndReset();
+        for (const auto& d : last.digests) collected += d.calls;
+        exact = exact && collected == threads * per_thread && last.dropped == 0;
+
+        double records = static_cast<double>(per_thread);
+        std::cout << std::setw(7) << threads << std::setw(22) << map_ns / records << std::setw(23) << agg_ns / records
+                  << std::setw(14) << collections << (collected == threads * per_thread ? "" : "  [calls lost]")
+                  << std::endl;
+    }
+    std::cout << "(ns/record is wall time per record on each thread)" << std::endl;
+    std::cout << "=======================\n";
+    return exact ? 0 : 1;
+}
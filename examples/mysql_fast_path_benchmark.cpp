@@ -0,0 +1,252 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_session_state.h"
+#include "mysql_parser/mysql_statement.h"
+#include "mysql_parser/mysql_symbol_table.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::Statement;
+
+// Differential check of the fast-path recognizer: every statement of a corpus
+// is parsed with the fast path on and off, and the trees (including symbols),
+// status, errors, digest, typed statement and session-state changes must be
+// identical. The corpus is the hot shapes, near misses that must fall back
+// to the grammar, and any files given with -f (one statement per line).
+// Then times the hot shapes both ways.
+// Usage: mysql_fast_path_benchmark [-i iterations] [-f file]...
+
+bool same_tree(const AstNode* a, const AstNode* b) {
+    if (!a || !b) return a == b;
+    if (a->type != b->type || a->value != b->value || a->escaped != b->escaped || a->symbol != b->symbol ||
+        a->children.size() != b->children.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a->children.size(); ++i) {
+        if (!same_tree(a->children[i], b->children[i])) return false;
+    }
+    return true;
+}
+
+// Where a typed-statement field points: -1 for nullptr, else the index of
+// the root's child, or the root itself as its children count
+long slot(const AstNode* root, const AstNode* field) {
+    if (!field) return -1;
+    for (size_t i = 0; i < root->children.size(); ++i) {
+        if (root->children[i] == field) return static_cast<long>(i);
+    }
+    return field == root ? static_cast<long>(root->children.size()) : -2;
+}
+
+std::vector<long> slots(const Statement& s) {
+    const AstNode* r = s.node;
+    if (!r) return {static_cast<long>(s.kind)};
+    return {static_cast<long>(s.kind),
+            slot(r, s.select.options), slot(r, s.select.items), slot(r, s.select.into), slot(r, s.select.from),
+            slot(r, s.select.where), slot(r, s.select.group_by), slot(r, s.select.having),
+            slot(r, s.select.order_by), slot(r, s.select.limit), slot(r, s.select.locking),
+            slot(r, s.insert.table), slot(r, s.insert.columns), slot(r, s.insert.values),
+            slot(r, s.del.options), slot(r, s.del.table), slot(r, s.del.targets), slot(r, s.del.from),
+            slot(r, s.del.using_tables), slot(r, s.del.where), slot(r, s.del.order_by), slot(r, s.del.limit),
+            slot(r, s.set.assignments), slot(r, s.set.names), slot(r, s.set.charset),
+            slot(r, s.set.transaction)};
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 50;
+    std::vector<std::string> corpus = {
+        // Hot shapes
+        "SELECT id, name FROM users WHERE id = 42",
+        "SELECT id, name FROM users WHERE id = 42;",
+        "select Id,Name from Users where Id=42 ;",
+        "SELECT * FROM orders WHERE order_id = 'A-1'",
+        "SELECT *, total FROM shop.orders WHERE orders.id = 7",
+        "SELECT u.id, u.email FROM users WHERE u.id = 3.25",
+        "SELECT `select`, `from` FROM `my table` WHERE `where` = \"it\"\"s\"",
+        "SELECT a FROM t WHERE b = 'it''s'",
+        "SELECT a FROM t WHERE b = ''",
+        "SELECT a FROM t",
+        "SELECT 1",
+        "SELECT 1;",
+        "SELECT a FROM t WHERE 1 = b",
+        "SELECT a\tFROM\nt\r\nWHERE b = 1",
+        "SELECT selected, fromage FROM wherever WHERE setting = 1",
+        "INSERT INTO audit_log (user_id, action, note) VALUES (1, 'login', \"ok\")",
+        "INSERT INTO audit_log VALUES (1, 'login')",
+        "INSERT INTO db.audit_log (a) VALUES (1), (2), (3);",
+        "INSERT INTO t (a, b) VALUES (x, y.z)",
+        "SET autocommit = 1",
+        "SET autocommit=0;",
+        "SET sql_mode = 'TRADITIONAL', wait_timeout = 60",
+        "SET `autocommit` = ON_VALUE",
+        "BEGIN",
+        "BEGIN;",
+        "COMMIT",
+        "commit ;",
+        // Near misses, left to the grammar
+        "",
+        ";",
+        "SELECT a FROM t WHERE b = -1",
+        "SELECT a FROM t WHERE b = 1 AND c = 2",
+        "SELECT a FROM t WHERE b > 1",
+        "SELECT a FROM t WHERE b = 'x\\'y'",
+        "SELECT a FROM t WHERE b = 'unterminated",
+        "SELECT a FROM t WHERE b = 1e5",
+        "SELECT a FROM t WHERE b = 0x1F",
+        "SELECT a FROM t WHERE b = X'1F'",
+        "SELECT a FROM t WHERE b = 1.",
+        "SELECT a FROM t WHERE b = 12abc",
+        "SELECT a AS x FROM t",
+        "SELECT a x FROM t",
+        "SELECT t.* FROM t",
+        "SELECT COUNT(*) FROM t",
+        "SELECT NOW() FROM t",
+        "SELECT a FROM t u WHERE b = 1",
+        "SELECT a FROM t WHERE b = 1 LIMIT 1",
+        "SELECT a FROM t WHERE b = 1 ORDER BY a",
+        "SELECT a FROM t WHERE b = 1 FOR UPDATE",
+        "SELECT a FROM t, u WHERE b = 1",
+        "SELECT a FROM t JOIN u ON t.id = u.id",
+        "SELECT DISTINCT a FROM t",
+        "SELECT a FROM t WHERE b = 1;;",
+        "SELECT a FROM t WHERE b = 1; SELECT 2",
+        "SELECT a FROM t /* comment */ WHERE b = 1",
+        "SELECT /*+ MAX_EXECUTION_TIME(10) */ a FROM t",
+        "SELECT a FROM t WHERE b = 1 -- trailing",
+        "SELECT a FROM t WHERE b = 1 # trailing",
+        "SELECT caf\xC3\xA9 FROM t",
+        "SELECT a FROM t WHERE b = 'caf\xC3\xA9'",
+        "SELECT a FROM t WHERE b = \xFF",
+        "SELECT `a\nb` FROM t",
+        "SELECT a FROM `t",
+        "SELECT a FROM t WHERE b = 1 $",
+        "SELECT a FROM t WHERE b = @v",
+        "SELECT FROM t",
+        "SELECT a, FROM t",
+        "SELECT a FROM",
+        "SELECT a FROM t WHERE",
+        "SELECT a FROM t WHERE b",
+        "SELECT a FROM t WHERE b =",
+        "SELECT a FROM t.",
+        "SELECT a FROM t WHERE b = 1\f",
+        "INSERT INTO t VALUES (NULL)",
+        "INSERT INTO t VALUES (DEFAULT)",
+        "INSERT INTO t VALUES (NOW())",
+        "INSERT INTO t VALUES (-1)",
+        "INSERT INTO t () VALUES (1)",
+        "INSERT INTO t (a.b) VALUES (1)",
+        "INSERT INTO t (a) VALUES ()",
+        "INSERT INTO t (a) VALUES (1),",
+        "INSERT INTO t (a) VALUES (1) (2)",
+        "INSERT INTO t (a VALUES (1)",
+        "INSERT t VALUES (1)",
+        "INSERT INTO t SELECT 1",
+        "SET @v = 1",
+        "SET @@session.autocommit = 1",
+        "SET SESSION autocommit = 1",
+        "SET GLOBAL max_connections = 10",
+        "SET NAMES utf8mb4",
+        "SET CHARACTER SET utf8",
+        "SET TRANSACTION ISOLATION LEVEL READ COMMITTED",
+        "SET autocommit = DEFAULT",
+        "SET autocommit = ON",
+        "SET autocommit",
+        "SET autocommit = 1,",
+        "SET a.b = 1",
+        "BEGIN WORK",
+        "COMMIT 1",
+        "QUIT",
+        "SHOW DATABASES",
+        "DELETE FROM t WHERE id = 1",
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else if (arg == "-f" && i + 1 < argc) {
+            std::ifstream in(argv[++i]);
+            if (!in) {
+                std::cerr << "Cannot read " << argv[i] << std::endl;
+                return 1;
+            }
+            for (std::string line; std::getline(in, line);) {
+                if (!line.empty()) corpus.push_back(line);
+            }
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    // One symbol table for both, so equal names get equal symbols
+    MysqlParser::SymbolTable symbols;
+    MysqlParser::Parser fast, grammar;
+    grammar.setFastPath(false);
+    MysqlParser::SessionState fast_session, grammar_session;
+    fast.setSessionState(&fast_session);
+    grammar.setSessionState(&grammar_session);
+    fast.setSymbolTable(&symbols);
+    grammar.setSymbolTable(&symbols);
+
+    size_t mismatches = 0, parsed = 0;
+    auto check = [&](const std::string& q, const MysqlParser::ParseLimits* limits) {
+        auto a = limits ? fast.parse(q, *limits) : fast.parse(q);
+        auto b = limits ? grammar.parse(q, *limits) : grammar.parse(q);
+        std::string what;
+        if (!same_tree(a.get(), b.get())) what += " tree";
+        if (fast.getStatus() != grammar.getStatus()) what += " status";
+        if (fast.getErrors() != grammar.getErrors()) what += " errors";
+        if (fast.getDigest() != grammar.getDigest()) what += " digest";
+        if (slots(fast.getStatement()) != slots(grammar.getStatement())) what += " statement";
+        if (fast_session != grammar_session) what += " session";
+        if (!what.empty()) {
+            std::cerr << "Mismatch (" << what.substr(1) << (limits ? ", with limits" : "") << "): " << q << std::endl;
+            ++mismatches;
+        }
+        if (a && !limits) ++parsed;
+    };
+    MysqlParser::ParseLimits tight;
+    tight.max_tokens = 6;
+    tight.max_nodes = 8;
+    for (const auto& q : corpus) {
+        check(q, nullptr);
+        check(q, &tight);
+    }
+
+    std::vector<std::string> hot;
+    for (int i = 0; i < 1000; ++i) {
+        std::string n = std::to_string(i);
+        hot.push_back("SELECT id, name, email FROM users WHERE id = " + n + ";");
+        hot.push_back("INSERT INTO audit_log (user_id, action, created_at) VALUES (" + n + ", 'login', '2024-01-01');");
+        hot.push_back("SET autocommit = " + std::to_string(i % 2) + ";");
+        hot.push_back("BEGIN;");
+        hot.push_back("COMMIT;");
+    }
+    using clock = std::chrono::steady_clock;
+    auto time_parser = [&](MysqlParser::Parser& parser) {
+        for (const auto& q : hot) parser.parse(q); // Warm up
+        auto start = clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            for (const auto& q : hot) parser.parse(q);
+        }
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * hot.size());
+    };
+    MysqlParser::Parser timed_fast, timed_grammar;
+    timed_grammar.setFastPath(false);
+    double grammar_ns = time_parser(timed_grammar);
+    double fast_ns = time_parser(timed_fast);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Differential corpus:  " << corpus.size() << " statements, with and without limits; "
+              << parsed << " parsed, " << mismatches << " mismatches" << std::endl;
+    std::cout << "Hot shapes, grammar:  " << grammar_ns << " ns/statement" << std::endl;
+    std::cout << "Hot shapes, fast path: " << fast_ns << " ns/statement (" << grammar_ns / fast_ns << "x)" << std::endl;
+    std::cout << "=======================\n";
+    return mismatches == 0 ? 0 : 1;
+}
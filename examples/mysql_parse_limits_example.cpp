@@ -0,0 +1,98 @@
+#include "mysql_parser/mysql_parser.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::NodeType;
+using MysqlParser::ParseStatus;
+
+const char* status_name(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::Ok: return "Ok";
+        case ParseStatus::SyntaxError: return "SyntaxError";
+        case ParseStatus::ScannerError: return "ScannerError";
+        case ParseStatus::BytesExceeded: return "BytesExceeded";
+        case ParseStatus::TokensExceeded: return "TokensExceeded";
+        case ParseStatus::NodesExceeded: return "NodesExceeded";
+        case ParseStatus::DepthExceeded: return "DepthExceeded";
+        case ParseStatus::DeadlineExceeded: return "DeadlineExceeded";
+    }
+    return "?";
+}
+
+// Feeds hostile queries to a parser with and without ParseLimits and reports
+// how long each takes to be rejected, then tears down a very deep tree to
+// show that ~AstNode does not recurse.
+// Usage: mysql_parse_limits_example [-n size]
+int main(int argc, char* argv[]) {
+    size_t n = 5000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            n = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    struct Case {
+        std::string name;
+        std::string sql;
+    };
+    std::vector<Case> cases;
+    cases.push_back({"Nested parentheses", "SELECT " + std::string(n, '(') + "1" + std::string(n, ')') + ";"});
+    cases.push_back({"Huge string literal", "SELECT '" + std::string(n * 10000, 'x') + "';"});
+    std::string wide = "SELECT COALESCE(0";
+    for (size_t i = 0; i < n * 20; ++i) wide += ", " + std::to_string(i);
+    cases.push_back({"Long argument list", wide + ");"});
+    std::string many_ands = "SELECT a FROM t WHERE a = 0";
+    for (size_t i = 0; i < n * 10; ++i) many_ands += " AND a = " + std::to_string(i);
+    cases.push_back({"Long AND chain", many_ands + ";"});
+
+    MysqlParser::ParseLimits limits;
+    limits.max_bytes = 1 << 20;
+    limits.max_tokens = 10000;
+    limits.max_nodes = 20000;
+    limits.max_depth = 64;
+    limits.max_time_us = 50000;
+
+    using clock = std::chrono::high_resolution_clock;
+    MysqlParser::Parser parser;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& c : cases) {
+        for (int limited = 0; limited < 2; ++limited) {
+            auto start = clock::now();
+            auto ast = limited ? parser.parse(c.sql, limits) : parser.parse(c.sql);
+            ast.reset(); // Teardown is part of the cost
+            double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            std::cout << std::left << std::setw(20) << c.name << (limited ? " limited:   " : " unlimited: ")
+                      << std::setw(17) << status_name(parser.getStatus()) << ms << " ms";
+            if (!parser.getErrors().empty()) {
+                std::string first = parser.getErrors().front();
+                if (first.size() > 60) first = first.substr(0, 60) + "...";
+                std::cout << "  (" << first << ")";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    // A degenerate tree far deeper than the native stack would allow with a recursive destructor
+    const size_t depth = 5000000;
+    auto start = clock::now();
+    {
+        auto root = std::make_unique<AstNode>(NodeType::NODE_SUBQUERY);
+        AstNode* tail = root.get();
+        for (size_t i = 0; i < depth; ++i) {
+            AstNode* child = new AstNode(NodeType::NODE_SUBQUERY);
+            tail->addChild(child);
+            tail = child;
+        }
+    }
+    double teardown_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    std::cout << "Built and destroyed a chain of " << depth << " nodes in " << teardown_ms << " ms" << std::endl;
+    return 0;
+}
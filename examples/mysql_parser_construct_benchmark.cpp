@@ -0,0 +1,75 @@
+#include "mysql_parser/mysql_parser.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+// Measures the cost of short-lived parsers, e.g. one per client connection:
+// constructing a Parser, its first parse (which takes a scanner from the
+// shared pool) and its destruction (which returns the scanner).
+// Usage: mysql_parser_construct_benchmark [-n parsers]
+int main(int argc, char* argv[]) {
+    long n = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            n = std::stol(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (n <= 0) n = 1;
+
+    const std::string query = "SELECT name FROM users WHERE id = 1;";
+    using clock = std::chrono::high_resolution_clock;
+    auto ns_per = [n](clock::duration d) {
+        return std::chrono::duration<double, std::nano>(d).count() / n;
+    };
+
+    // Construct + destroy only
+    auto start = clock::now();
+    for (long i = 0; i < n; ++i) {
+        MysqlParser::Parser parser;
+    }
+    double construct_ns = ns_per(clock::now() - start);
+
+    // Construct + first parse + destroy
+    long ok = 0;
+    start = clock::now();
+    for (long i = 0; i < n; ++i) {
+        MysqlParser::Parser parser;
+        if (parser.parse(query)) ok++;
+    }
+    double lifecycle_ns = ns_per(clock::now() - start);
+
+    // Parse only, on one long-lived parser
+    MysqlParser::Parser parser;
+    start = clock::now();
+    for (long i = 0; i < n; ++i) {
+        if (parser.parse(query)) ok++;
+    }
+    double parse_ns = ns_per(clock::now() - start);
+
+    // Many live parsers at once, as with many open connections
+    const size_t live = 10000;
+    start = clock::now();
+    {
+        std::vector<MysqlParser::Parser> parsers(live);
+        for (auto& p : parsers) {
+            if (p.parse(query)) ok++;
+        }
+    }
+    double live_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / live;
+
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Parsers: " << n << " (successful parses: " << ok << ")" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Construct + destroy:               " << construct_ns << " ns/parser" << std::endl;
+    std::cout << "Construct + parse + destroy:       " << lifecycle_ns << " ns/parser" << std::endl;
+    std::cout << "Parse on a long-lived parser:      " << parse_ns << " ns/query" << std::endl;
+    std::cout << live << " live parsers, one parse each: " << live_ns << " ns/parser" << std::endl;
+    std::cout << "=======================\n";
+    return 0;
+}
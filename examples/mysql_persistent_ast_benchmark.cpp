@@ -0,0 +1,158 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_persistent_ast.h"
+#include "counting_allocator.h" // Counts heap allocations made by each way of rewriting
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::AstPath;
+using MysqlParser::NodeType;
+using MysqlParser::PersistentNode;
+using MysqlParser::PersistentNodePtr;
+
+// Derives a rewritten statement from a cached template (a renamed table plus
+// an added LIMIT) three ways: re-parsing the rewritten SQL, deep-copying the
+// template and editing the copy, and path copying on the persistent tree.
+// Checks that all three agree with each other and that the template is left
+// unchanged, then reports time, allocations and nodes shared per rewrite.
+// Usage: mysql_persistent_ast_benchmark [-i iterations]
+
+const char* kTemplate = "SELECT c.name, c.email FROM customers c WHERE c.region = 'EU' ORDER BY c.name";
+const char* kRewritten = "SELECT c.name, c.email FROM customers_eu c WHERE c.region = 'EU' ORDER BY c.name LIMIT 50";
+
+// Index at which a LIMIT clause goes among a SELECT's children: last, unless
+// there is a locking clause
+size_t limit_position(size_t count, NodeType last) {
+    return count > 0 && last == NodeType::NODE_LOCKING_CLAUSE_LIST ? count - 1 : count;
+}
+
+bool is_table(NodeType type, const std::string& value) {
+    return type == NodeType::NODE_IDENTIFIER && value == "customers";
+}
+
+PersistentNodePtr rewrite_persistent(const PersistentNodePtr& root) {
+    AstPath path;
+    if (!MysqlParser::find_path(root.get(), [](const PersistentNode& n) { return is_table(n.type, n.value); }, &path)) {
+        return nullptr;
+    }
+    PersistentNodePtr renamed = MysqlParser::replace_at(root, path,
+                                                        MysqlParser::with_value(*MysqlParser::node_at(root.get(), path), "customers_eu"));
+    auto limit = std::make_shared<PersistentNode>(NodeType::NODE_LIMIT_CLAUSE);
+    limit->children.push_back(std::make_shared<PersistentNode>(NodeType::NODE_NUMBER_LITERAL, "50"));
+    size_t at = limit_position(renamed->children.size(),
+                               renamed->children.empty() ? NodeType::NODE_UNKNOWN : renamed->children.back()->type);
+    return MysqlParser::with_inserted_child(*renamed, at, std::move(limit));
+}
+
+std::unique_ptr<AstNode> rewrite_deep_copy(const PersistentNode* root) {
+    std::unique_ptr<AstNode> copy = MysqlParser::materialize_ast(root);
+    std::vector<AstNode*> stack{copy.get()};
+    while (!stack.empty()) {
+        AstNode* node = stack.back();
+        stack.pop_back();
+        if (is_table(node->type, node->value)) {
+            node->value = "customers_eu";
+            break;
+        }
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) stack.push_back(*it);
+    }
+    AstNode* limit = new AstNode(NodeType::NODE_LIMIT_CLAUSE);
+    limit->addChild(new AstNode(NodeType::NODE_NUMBER_LITERAL, "50"));
+    size_t at = limit_position(copy->children.size(),
+                               copy->children.empty() ? NodeType::NODE_UNKNOWN : copy->children.back()->type);
+    copy->children.insert(copy->children.begin() + at, limit);
+    return copy;
+}
+
+void collect(const PersistentNode* node, std::unordered_set<const PersistentNode*>& out) {
+    std::vector<const PersistentNode*> stack{node};
+    while (!stack.empty()) {
+        const PersistentNode* n = stack.back();
+        stack.pop_back();
+        out.insert(n);
+        for (const PersistentNodePtr& c : n->children) stack.push_back(c.get());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 20000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    MysqlParser::Parser parser;
+    std::unique_ptr<AstNode> parsed_template = parser.parse(kTemplate);
+    std::unique_ptr<AstNode> parsed_rewrite = parser.parse(kRewritten);
+    if (!parsed_template || !parsed_rewrite) {
+        std::cerr << "Failed to parse the template or its rewrite" << std::endl;
+        return 1;
+    }
+    const PersistentNodePtr cached = MysqlParser::make_persistent(parsed_template.get());
+    const PersistentNodePtr expected = MysqlParser::make_persistent(parsed_rewrite.get());
+
+    // Correctness: every way gives the re-parsed tree, and the template survives
+    size_t failures = 0;
+    PersistentNodePtr rewritten = rewrite_persistent(cached);
+    if (!rewritten || !MysqlParser::same_tree(rewritten.get(), expected.get())) {
+        std::cerr << "Path-copied rewrite differs from the re-parsed statement" << std::endl;
+        ++failures;
+    }
+    auto materialized = MysqlParser::materialize_ast(rewritten.get());
+    if (!MysqlParser::same_tree(MysqlParser::make_persistent(materialized.get()).get(), expected.get())) {
+        std::cerr << "Materialized rewrite differs from the re-parsed statement" << std::endl;
+        ++failures;
+    }
+    auto copied = rewrite_deep_copy(cached.get());
+    if (!MysqlParser::same_tree(MysqlParser::make_persistent(copied.get()).get(), expected.get())) {
+        std::cerr << "Deep-copied rewrite differs from the re-parsed statement" << std::endl;
+        ++failures;
+    }
+    if (!MysqlParser::same_tree(cached.get(), MysqlParser::make_persistent(parsed_template.get()).get())) {
+        std::cerr << "Rewriting changed the template" << std::endl;
+        ++failures;
+    }
+
+    std::unordered_set<const PersistentNode*> template_nodes, rewrite_nodes;
+    collect(cached.get(), template_nodes);
+    collect(rewritten.get(), rewrite_nodes);
+    size_t shared = 0;
+    for (const PersistentNode* n : rewrite_nodes) shared += template_nodes.count(n);
+
+    using clock = std::chrono::steady_clock;
+    struct Cost { double ns; double allocations; };
+    auto measure = [&](auto&& rewrite) {
+        size_t before = g_allocations.load();
+        auto start = clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            if (!rewrite()) ++failures;
+        }
+        double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+        return Cost{ns, static_cast<double>(g_allocations.load() - before) / iterations};
+    };
+    Cost reparse = measure([&] { return parser.parse(kRewritten) != nullptr; });
+    Cost deep = measure([&] { return rewrite_deep_copy(cached.get()) != nullptr; });
+    Cost path = measure([&] { return rewrite_persistent(cached) != nullptr; });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Template nodes:   " << template_nodes.size() << "; rewrite shares " << shared << " of "
+              << rewrite_nodes.size() << std::endl;
+    std::cout << "Re-parse:         " << reparse.ns << " ns/rewrite, " << reparse.allocations << " allocations" << std::endl;
+    std::cout << "Deep copy + edit: " << deep.ns << " ns/rewrite, " << deep.allocations << " allocations" << std::endl;
+    std::cout << "Path copy:        " << path.ns << " ns/rewrite, " << path.allocations << " allocations ("
+              << reparse.ns / path.ns << "x vs re-parse)" << std::endl;
+    std::cout << "Failures:         " << failures << std::endl;
+    std::cout << "=======================\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_query_comments.h"
+#include "counting_allocator.h" // Counts heap allocations, to show that comments cost none
+#include <iostream>
+#include <string>
+#include <vector>
+#include <regex>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::CommentKind;
+
+const char* kind_name(CommentKind kind) {
+    switch (kind) {
+        case CommentKind::Block: return "block";
+        case CommentKind::Hint: return "hint";
+        case CommentKind::Versioned: return "versioned";
+        case CommentKind::Line: return "line";
+    }
+    return "?";
+}
+
+size_t allocations_for(MysqlParser::Parser& parser, const std::string& sql) {
+    size_t before = g_allocations.load();
+    auto ast = parser.parse(sql);
+    size_t after = g_allocations.load();
+    return after - before;
+}
+
+// Shows the comments, optimizer hints and key=value routing annotations the
+// lexer records while parsing, and compares the cost of routing on them with
+// the old approach of a regex pass over the raw query after parsing.
+// Usage: mysql_query_comments_example [-i iterations]
+int main(int argc, char* argv[]) {
+    int iterations = 100000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    const std::vector<std::string> queries = {
+        "SELECT /*+ MAX_EXECUTION_TIME(1000) NO_INDEX_MERGE(t) */ a FROM t WHERE id = 1;",
+        "/* hostgroup=2, user='report svc' */ SELECT COUNT(*) FROM orders;",
+        "SELECT a FROM t; -- shard_key=42 tenant=acme",
+        "DELETE FROM sessions WHERE expires < 1700000000 # retry=0",
+        "SELECT /*! SQL_NO_CACHE */ a FROM t;",
+        "SELECT a FROM t WHERE b = 1;"
+    };
+
+    MysqlParser::Parser parser;
+    for (const auto& q : queries) {
+        auto ast = parser.parse(q);
+        std::cout << q << (ast ? "" : "  [parse failed]") << std::endl;
+        const MysqlParser::QueryComments& comments = parser.getComments();
+        for (const auto& c : comments.comments) {
+            std::cout << "  " << kind_name(c.kind) << " @" << c.offset << ": \"" << c.text(q) << "\"" << std::endl;
+        }
+        for (const auto& a : comments.annotations) {
+            std::cout << "  annotation " << a.key(q) << " = " << a.value(q) << std::endl;
+        }
+    }
+
+    // Everything below goes through the scanner: the fast path would take the
+    // plain statements and record no comments
+    parser.setFastPath(false);
+
+    // Annotations mixed with bare words and stray punctuation: (key, value) in order
+    struct AnnotationCase { std::string sql; std::vector<std::pair<std::string, std::string>> expected; };
+    const std::vector<AnnotationCase> annotation_cases = {
+        {"/* checkout hostgroup=2 */ SELECT 1;", {{"hostgroup", "2"}}},
+        {"/* app: checkout hostgroup=2, user='svc' */ SELECT 1;", {{"hostgroup", "2"}, {"user", "svc"}}},
+        {"/* = x hostgroup = 3 */ SELECT 1;", {{"hostgroup", "3"}}},
+    };
+    size_t annotation_failures = 0;
+    for (const auto& c : annotation_cases) {
+        auto ast = parser.parse(c.sql);
+        const auto& found = parser.getComments().annotations;
+        bool ok = ast && found.size() == c.expected.size();
+        for (size_t i = 0; ok && i < found.size(); ++i) {
+            ok = found[i].key(c.sql) == c.expected[i].first && found[i].value(c.sql) == c.expected[i].second;
+        }
+        if (!ok) {
+            std::cerr << "Annotation mismatch: " << c.sql << std::endl;
+            ++annotation_failures;
+        }
+    }
+
+    // Same statement with and without a routing comment
+    const std::string plain = "SELECT a, b FROM t WHERE id = 1;";
+    const std::string annotated = "SELECT /* hostgroup=2 */ a, b FROM t WHERE id = 1; -- tenant=acme";
+    allocations_for(parser, annotated); // Warm up
+    size_t plain_allocs = allocations_for(parser, plain);
+    size_t annotated_allocs = allocations_for(parser, annotated);
+
+    // Routing on the hostgroup annotation: lexer-recorded vs a second regex pass
+    using clock = std::chrono::high_resolution_clock;
+    const std::regex hostgroup_re("/\\*[^*]*\\bhostgroup\\s*=\\s*([0-9]+)", std::regex::icase);
+    size_t via_lexer = 0, via_regex = 0;
+    auto start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        auto ast = parser.parse(annotated);
+        const auto* a = parser.getComments().findAnnotation(annotated, "hostgroup");
+        if (a) via_lexer += a->value(annotated).size();
+    }
+    double lexer_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        auto ast = parser.parse(annotated);
+        std::smatch m;
+        if (std::regex_search(annotated, m, hostgroup_re)) via_regex += m[1].length();
+    }
+    double regex_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Annotation cases: " << annotation_cases.size() << ", " << annotation_failures << " failures" << std::endl;
+    std::cout << "Heap allocations per parse: " << plain_allocs << " plain, " << annotated_allocs
+              << " with two annotated comments" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Parse + lexer annotations: " << lexer_ns << " ns/query" << std::endl;
+    std::cout << "Parse + regex pass:        " << regex_ns << " ns/query" << std::endl;
+    std::cout << "=======================\n";
+    return (annotation_failures == 0 && via_lexer == via_regex && plain_allocs == annotated_allocs) ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_query_rules.h"
+#include "mysql_parser/mysql_bulk_parser.h" // For BulkParser::splitStatements
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <regex>
+#include <algorithm>
+#include <random>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::NodeType;
+using MysqlParser::QueryRule;
+using MysqlParser::LockMatch;
+using MysqlParser::LimitMatch;
+
+// Evaluates N routing rules per query three ways:
+//   1. the old approach, a set of regexes per rule over the raw SQL text
+//   2. QueryRule::matches() for every rule (linear in the number of rules)
+//   3. a compiled QueryRuleSet
+// and checks that 2 and 3 select the same rules.
+// Usage: mysql_query_rules_benchmark [-r rules] [-i iterations] [-f file.sql]
+//
+// Without -f, a corpus in the style of main_mysql_example/set_mysql_example is used.
+
+const std::vector<std::string> kDefaultCorpus = {
+    "SELECT name FROM users WHERE id = 42;",
+    "SELECT * FROM t17 WHERE id = 1 FOR UPDATE;",
+    "SELECT a, b FROM shop.t3 JOIN t8 ON t3.id = t8.id WHERE t3.x > 10 LIMIT 20;",
+    "SELECT COUNT(*) FROM t42 GROUP BY category HAVING COUNT(*) > 5;",
+    "SELECT * FROM t5 WHERE k = 'x' LIMIT 1 FOR SHARE;",
+    "SELECT dt.c FROM (SELECT c FROM t99 WHERE c > 0) AS dt ORDER BY dt.c DESC;",
+    "INSERT INTO t12 (id, v) VALUES (1, 'a'), (2, 'b');",
+    "INSERT INTO shop.t3 VALUES (NOW(), 1);",
+    "DELETE FROM t21 WHERE created < '2020-01-01' LIMIT 1000;",
+    "DELETE t1, t2 FROM t1 JOIN t2 ON t1.a = t2.a WHERE t1.b = 0;",
+    "SET autocommit = 0;",
+    "SET @@session.sql_mode = 'STRICT_ALL_TABLES', @@global.max_connections = 500;",
+    "SET SESSION transaction_isolation = 'READ-COMMITTED';",
+    "SET NAMES utf8mb4;",
+    "SET @counter = 10;",
+    "SELECT @@version;",
+    "BEGIN;",
+    "COMMIT;",
+    "SHOW DATABASES;"
+};
+
+const std::vector<std::string> kVariables = {
+    "autocommit", "sql_mode", "max_connections", "transaction_isolation", "version",
+    "wait_timeout", "time_zone", "character_set_client", "sql_log_bin", "foreign_key_checks"
+};
+
+struct RegexRule {
+    std::vector<std::regex> all_of; // Every regex must match somewhere in the text
+};
+
+// Builds the regex form a proxy config would typically carry for the same rule
+RegexRule to_regex_rule(const QueryRule& rule) {
+    const auto flags = std::regex::icase | std::regex::optimize;
+    RegexRule out;
+    switch (rule.statement) {
+        case NodeType::NODE_SELECT_STATEMENT: out.all_of.emplace_back("^\\s*SELECT\\b", flags); break;
+        case NodeType::NODE_INSERT_STATEMENT: out.all_of.emplace_back("^\\s*INSERT\\b", flags); break;
+        case NodeType::NODE_DELETE_STATEMENT: out.all_of.emplace_back("^\\s*DELETE\\b", flags); break;
+        case NodeType::NODE_SET_STATEMENT:    out.all_of.emplace_back("^\\s*SET\\b", flags); break;
+        default: break;
+    }
+    auto alternation = [](const std::vector<std::string>& names) {
+        std::string s = "\\b(";
+        for (size_t i = 0; i < names.size(); ++i) s += (i ? "|" : "") + names[i];
+        return s + ")\\b";
+    };
+    if (!rule.tables.empty()) out.all_of.emplace_back(alternation(rule.tables), flags);
+    if (!rule.system_variables.empty()) out.all_of.emplace_back("@@(\\w+\\.)?" + alternation(rule.system_variables).substr(2), flags);
+    switch (rule.lock) {
+        case LockMatch::ForUpdate: out.all_of.emplace_back("FOR\\s+UPDATE\\s*;?\\s*$", flags); break;
+        case LockMatch::ForShare:  out.all_of.emplace_back("FOR\\s+SHARE\\s*;?\\s*$", flags); break;
+        case LockMatch::Locking:   out.all_of.emplace_back("FOR\\s+(UPDATE|SHARE)\\s*;?\\s*$", flags); break;
+        default: break; // None cannot be expressed with a positive regex; proxies use negate flags
+    }
+    if (rule.limit == LimitMatch::Present) out.all_of.emplace_back("\\bLIMIT\\s+\\d", flags);
+    return out;
+}
+
+std::vector<QueryRule> make_rules(size_t count) {
+    std::mt19937 rng(12345);
+    auto pick = [&](size_t n) { return static_cast<size_t>(rng() % n); };
+    const NodeType statements[] = {
+        NodeType::NODE_UNKNOWN, NodeType::NODE_SELECT_STATEMENT, NodeType::NODE_SELECT_STATEMENT,
+        NodeType::NODE_INSERT_STATEMENT, NodeType::NODE_DELETE_STATEMENT, NodeType::NODE_SET_STATEMENT
+    };
+    std::vector<QueryRule> rules;
+    for (size_t i = 0; i < count; ++i) {
+        QueryRule rule;
+        rule.id = static_cast<int>(i);
+        rule.statement = statements[pick(6)];
+        if (rule.statement == NodeType::NODE_SET_STATEMENT) {
+            rule.system_variables.push_back(kVariables[pick(kVariables.size())]);
+        } else {
+            size_t n_tables = 1 + pick(3);
+            for (size_t t = 0; t < n_tables; ++t) rule.tables.push_back("t" + std::to_string(pick(200)));
+            if (pick(4) == 0) rule.tables.push_back("users");
+        }
+        if (rule.statement == NodeType::NODE_SELECT_STATEMENT) {
+            const LockMatch locks[] = {LockMatch::Any, LockMatch::Any, LockMatch::ForUpdate, LockMatch::ForShare, LockMatch::Locking};
+            rule.lock = locks[pick(5)];
+            if (pick(3) == 0) rule.limit = LimitMatch::Present;
+        }
+        rules.push_back(std::move(rule));
+    }
+    return rules;
+}
+
+int main(int argc, char* argv[]) {
+    size_t rule_count = 1000;
+    int iterations = 2000;
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-r" && i + 1 < argc) {
+            rule_count = std::stoul(argv[++i]);
+        } else if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else if (arg == "-f" && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    std::vector<std::string> corpus = kDefaultCorpus;
+    if (!path.empty()) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            std::cerr << "Error: cannot open " << path << std::endl;
+            return 1;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string data = buffer.str();
+        corpus.clear();
+        for (const auto& span : MysqlParser::BulkParser::splitStatements(data.data(), data.size())) {
+            corpus.emplace_back(data, span.offset, span.length);
+        }
+    }
+
+    // Parse once; the rules engine works on the ASTs
+    MysqlParser::Parser parser;
+    std::vector<std::string> texts;
+    std::vector<MysqlParser::QueryFeatures> features;
+    for (const auto& q : corpus) {
+        auto ast = parser.parse(q);
+        parser.clearErrors();
+        if (!ast) continue;
+        texts.push_back(q);
+        features.emplace_back();
+        MysqlParser::extract_query_features(ast.get(), features.back());
+    }
+    if (texts.empty()) {
+        std::cerr << "Error: no statement in the corpus could be parsed" << std::endl;
+        return 1;
+    }
+
+    std::vector<QueryRule> rules = make_rules(rule_count);
+    MysqlParser::QueryRuleSet rule_set;
+    for (const auto& rule : rules) rule_set.addRule(rule);
+    rule_set.compile();
+    std::vector<RegexRule> regex_rules;
+    for (const auto& rule : rules) regex_rules.push_back(to_regex_rule(rule));
+
+    using clock = std::chrono::high_resolution_clock;
+    const double matches_per_pass = static_cast<double>(texts.size());
+
+    // 1. Regexes over raw text (fewer iterations: this is orders of magnitude slower)
+    int regex_iterations = std::max(1, iterations / 200);
+    size_t regex_hits = 0;
+    auto start = clock::now();
+    for (int it = 0; it < regex_iterations; ++it) {
+        for (const auto& text : texts) {
+            for (const auto& rr : regex_rules) {
+                bool ok = true;
+                for (const auto& re : rr.all_of) {
+                    if (!std::regex_search(text, re)) { ok = false; break; }
+                }
+                if (ok) { regex_hits++; break; } // First match wins
+            }
+        }
+    }
+    double regex_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (regex_iterations * matches_per_pass);
+
+    // 2. Linear scan over all rules
+    std::vector<std::vector<size_t>> linear_results(texts.size());
+    size_t linear_hits = 0;
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (size_t q = 0; q < features.size(); ++q) {
+            for (size_t r = 0; r < rules.size(); ++r) {
+                if (rules[r].matches(features[q])) { linear_hits++; break; }
+            }
+        }
+    }
+    double linear_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * matches_per_pass);
+    for (size_t q = 0; q < features.size(); ++q) {
+        for (size_t r = 0; r < rules.size(); ++r) {
+            if (rules[r].matches(features[q])) linear_results[q].push_back(r);
+        }
+    }
+
+    // 3. Compiled rule set
+    MysqlParser::RuleMatchSet matches;
+    size_t compiled_hits = 0;
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& f : features) {
+            rule_set.match(f, matches);
+            if (matches.first() >= 0) compiled_hits++;
+        }
+    }
+    double compiled_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * matches_per_pass);
+
+    bool same = true;
+    for (size_t q = 0; q < features.size(); ++q) {
+        rule_set.match(features[q], matches);
+        if (matches.indices() != linear_results[q]) {
+            std::cerr << "Mismatch for: " << texts[q] << std::endl;
+            same = false;
+        }
+    }
+
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Rules: " << rules.size() << ", statements: " << texts.size() << std::endl;
+    std::cout << "Statements with a matching rule: regex " << regex_hits / regex_iterations
+              << ", linear " << linear_hits / iterations << ", compiled " << compiled_hits / iterations << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Regexes over SQL text:     " << regex_ns << " ns/query" << std::endl;
+    std::cout << "Linear QueryRule::matches: " << linear_ns << " ns/query" << std::endl;
+    std::cout << "Compiled QueryRuleSet:     " << compiled_ns << " ns/query" << std::endl;
+    std::cout << "Compiled matches linear: " << (same ? "yes" : "NO") << std::endl;
+    std::cout << "=======================\n";
+    return same ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_session_state.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::NodeType;
+using MysqlParser::SessionState;
+using MysqlParser::VariableScope;
+
+const char* scope_name(VariableScope scope) {
+    switch (scope) {
+        case VariableScope::Session: return "SESSION";
+        case VariableScope::User: return "USER";
+        case VariableScope::NextTransaction: return "NEXT_TRANSACTION";
+    }
+    return "?";
+}
+
+void print_state(const std::string& label, const SessionState& state) {
+    std::cout << label << " (hash " << std::hex << state.hash() << std::dec << "):" << std::endl;
+    for (const auto& v : state.variables()) {
+        std::cout << "  " << scope_name(v.scope) << " " << MysqlParser::variable_name(v.id) << " = " << v.value << std::endl;
+    }
+}
+
+// The pre-SessionState approach: keep the SET ASTs and rebuild a name -> value
+// map by walking them whenever two sessions are compared.
+void legacy_collect(const AstNode* node, std::map<std::string, std::string>& vars) {
+    if (!node) return;
+    if (node->type == NodeType::NODE_VARIABLE_ASSIGNMENT && node->children.size() == 2) {
+        const AstNode* target = node->children[0];
+        const AstNode* value = node->children[1];
+        std::string key = (target->type == NodeType::NODE_USER_VARIABLE ? "@" : "") + target->value;
+        vars[key] = MysqlParser::format_session_value(value);
+        return;
+    }
+    for (const AstNode* child : node->children) legacy_collect(child, vars);
+}
+
+// Tracks two client sessions while they run SET statements and checks whether
+// they can share a backend connection.
+// Usage: mysql_session_state_example [-i iterations]
+int main(int argc, char* argv[]) {
+    int iterations = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    const std::vector<std::string> client_a = {
+        "SET NAMES utf8mb4;",
+        "SET autocommit = 0;",
+        "SET @@session.sql_mode = 'STRICT_ALL_TABLES';",
+        "SET @batch = 10;",
+        "SET @@global.max_connections = 500;", // Server state, not tracked
+        "SET SESSION TRANSACTION ISOLATION LEVEL READ COMMITTED;"
+    };
+    const std::vector<std::string> client_b = {
+        "SET SESSION TRANSACTION ISOLATION LEVEL READ COMMITTED;",
+        "SET @batch = 10, SESSION sql_mode = 'STRICT_ALL_TABLES';",
+        "SET NAMES utf8mb4;",
+        "SET AUTOCOMMIT = OFF;"
+    };
+
+    SessionState state_a, state_b;
+    std::vector<std::unique_ptr<AstNode>> asts_a, asts_b;
+    MysqlParser::Parser parser;
+
+    auto run = [&](const std::vector<std::string>& queries, SessionState& state, std::vector<std::unique_ptr<AstNode>>& asts) {
+        parser.setSessionState(&state);
+        for (const auto& q : queries) {
+            auto ast = parser.parse(q);
+            if (!ast) {
+                std::cerr << "Failed to parse: " << q << std::endl;
+                for (const auto& e : parser.getErrors()) std::cerr << "  Error: " << e << std::endl;
+                continue;
+            }
+            asts.push_back(std::move(ast));
+        }
+        parser.setSessionState(nullptr);
+    };
+    run(client_a, state_a, asts_a);
+    run(client_b, state_b, asts_b);
+
+    print_state("Client A", state_a);
+    print_state("Client B", state_b);
+
+    MysqlParser::SessionStateDiff diff = state_b.diff(state_a);
+    std::cout << "To move a backend from B's state to A's:" << std::endl;
+    for (const auto& v : diff.changed) {
+        std::cout << "  set " << scope_name(v.scope) << " " << MysqlParser::variable_name(v.id) << " = " << v.value << std::endl;
+    }
+    for (const auto& v : diff.removed) {
+        std::cout << "  reset " << scope_name(v.scope) << " " << MysqlParser::variable_name(v.id) << std::endl;
+    }
+
+    // A client that sets variables and resets them to DEFAULT is back to a
+    // fresh session's state, and can take any fresh backend connection
+    SessionState state_reset, state_fresh;
+    std::vector<std::unique_ptr<AstNode>> asts_reset;
+    run({"SET sql_mode = 'ANSI', @@session.wait_timeout = 60;",
+         "SET sql_mode = DEFAULT, SESSION wait_timeout = DEFAULT;"}, state_reset, asts_reset);
+    bool reset_ok = state_reset == state_fresh && state_reset.hash() == state_fresh.hash();
+    std::cout << "After SET ... = DEFAULT, equal to a fresh session: " << (reset_ok ? "yes" : "no") << std::endl;
+
+    // Cost of the "can this backend connection be reused" check
+    using clock = std::chrono::high_resolution_clock;
+    size_t legacy_equal = 0;
+    auto start = clock::now();
+    for (int it = 0; it < iterations / 100; ++it) {
+        std::map<std::string, std::string> vars_a, vars_b;
+        for (const auto& ast : asts_a) legacy_collect(ast.get(), vars_a);
+        for (const auto& ast : asts_b) legacy_collect(ast.get(), vars_b);
+        if (vars_a == vars_b) legacy_equal++;
+    }
+    double legacy_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / std::max(1, iterations / 100);
+
+    size_t hash_equal = 0;
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        const SessionState* volatile a = &state_a; // Keep the compare inside the loop
+        if (a->hash() == state_b.hash()) hash_equal++;
+    }
+    double hash_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "States equal: " << (state_a == state_b ? "yes" : "no") << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Tree walk + string map compare: " << legacy_ns << " ns/check" << std::endl;
+    std::cout << "SessionState hash compare:      " << hash_ns << " ns/check" << std::endl;
+    std::cout << "=======================\n";
+    return (legacy_equal > 0) == (hash_equal > 0) && reset_ok ? 0 : 1;
+}
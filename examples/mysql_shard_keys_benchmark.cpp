@@ -0,0 +1,206 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_shard_keys.h"
+#include "counting_allocator.h" // Counts heap allocations made by each way of routing
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::NodeType;
+using MysqlParser::ShardConstraint;
+using MysqlParser::ShardRouting;
+
+// Routes statements of a sharded schema (users and orders sharded on
+// user_id, app.events on tenant_id): checks the shard-key values and ranges
+// ShardKeySet::extract() finds against the expected ones, then times it
+// straight after a parse against collecting the same values with a
+// hand-written walk of the tree, counting allocations of each.
+// Usage: mysql_shard_keys_benchmark [-i iterations]
+
+// "users{1,2} orders[10,20) *": values, ranges, and * if it spans all shards
+std::string describe(const ShardRouting& r) {
+    std::string out;
+    for (size_t i = 0; i < r.constraint_count; ++i) {
+        const ShardConstraint& c = r.constraints[i];
+        if (!out.empty()) out += ' ';
+        out += std::string(c.qualifier);
+        auto text = [](const MysqlParser::ShardValue& v) {
+            std::string s = v.isString() ? "'" + std::string(v.text()) + "'" : std::string(v.text());
+            return v.negative ? "-" + s : s;
+        };
+        if (c.has_values) {
+            out += '{';
+            for (size_t v = 0; v < c.value_count; ++v) out += (v ? "," : "") + text(r.valuesOf(c)[v]);
+            out += '}';
+        }
+        if (c.lower.value.literal || c.upper.value.literal) {
+            out += c.lower.inclusive ? '[' : '(';
+            if (c.lower.value.literal) out += text(c.lower.value);
+            out += ',';
+            if (c.upper.value.literal) out += text(c.upper.value);
+            out += c.upper.inclusive ? ']' : ')';
+        }
+    }
+    if (r.spans_all_shards) out += out.empty() ? "*" : " *";
+    return out;
+}
+
+// The walk routing code writes by hand: equalities on user_id anywhere under
+// the WHERE clause, as strings
+void hand_written(const AstNode* node, std::vector<std::string>& values) {
+    if (!node) return;
+    if (node->type == NodeType::NODE_COMPARISON_EXPRESSION && node->value == "=" && node->children.size() == 2) {
+        const AstNode* column = node->children[0];
+        const AstNode* value = node->children[1];
+        std::string name = column->type == NodeType::NODE_QUALIFIED_IDENTIFIER ? column->children[1]->value : column->value;
+        if (name == "user_id" && (value->type == NodeType::NODE_NUMBER_LITERAL || value->type == NodeType::NODE_STRING_LITERAL)) {
+            values.push_back(value->value);
+        }
+        return;
+    }
+    for (const AstNode* c : node->children) hand_written(c, values);
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 20000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    MysqlParser::ShardKeySet keys;
+    keys.addKey("users", "user_id");
+    keys.addKey("orders", "user_id");
+    keys.addKey("app.events", "tenant_id");
+
+    struct Case { const char* sql; const char* expected; };
+    const std::vector<Case> cases = {
+        {"SELECT name FROM users WHERE user_id = 42", "users{42}"},
+        {"SELECT name FROM Users WHERE USER_ID = 42 AND name = 'x'", "Users{42}"},
+        {"SELECT name FROM users WHERE 42 = user_id", "users{42}"},
+        {"SELECT name FROM users WHERE user_id IN (1, 2, -3, 2)", "users{1,2,-3}"},
+        {"SELECT name FROM users WHERE user_id = 'abc'", "users{'abc'}"},
+        {"SELECT name FROM users WHERE status = 1 AND (user_id = 7 AND age > 3)", "users{7}"},
+        {"SELECT name FROM users WHERE user_id IN (1, 2, 3) AND user_id = 2", "users{2}"},
+        {"SELECT name FROM users WHERE user_id = 2 AND user_id IN (1, 2, 3)", "users{2}"},
+        {"SELECT name FROM users WHERE user_id >= 100 AND user_id < 200", "users[100,200) *"},
+        {"SELECT name FROM users WHERE user_id > 5 AND user_id > 10 AND 20 >= user_id", "users(10,20] *"},
+        {"SELECT name FROM users WHERE user_id != 42", "users *"},
+        {"SELECT name FROM users WHERE user_id NOT IN (1, 2)", "users *"},
+        {"SELECT name FROM users WHERE user_id IN (1, @v)", "users *"},
+        {"SELECT name FROM users WHERE user_id = other_id", "users *"},
+        {"SELECT name FROM users", "users *"},
+        {"SELECT name FROM products WHERE user_id = 42", ""},
+        {"SELECT 1", ""},
+        {"SELECT u.name, o.total FROM users u JOIN orders o ON o.user_id = u.user_id WHERE u.user_id = 9 AND o.user_id = 9",
+         "u{9} o{9}"},
+        {"SELECT u.name FROM users u JOIN orders o ON o.user_id = u.user_id WHERE u.user_id = 9", "u{9} o *"},
+        {"SELECT a.name FROM users a JOIN users b ON a.id = b.id WHERE a.user_id = 1 AND b.user_id = 2", "a{1} b{2}"},
+        {"SELECT users.name FROM users WHERE users.user_id = 3", "users{3}"},
+        {"SELECT name FROM users x WHERE y.user_id = 3", "x *"},
+        {"SELECT id FROM app.events WHERE tenant_id = 5", "events{5}"},
+        {"SELECT id FROM events WHERE tenant_id = 5", ""},
+        {"SELECT d.n FROM (SELECT name AS n FROM users WHERE user_id = 4) AS d WHERE d.n = 'x'", "users{4}"},
+        {"SELECT d.n FROM (SELECT name AS n FROM users) AS d WHERE user_id = 4", "users *"},
+        {"DELETE FROM users WHERE user_id = 42 LIMIT 1", "users{42}"},
+        {"DELETE FROM orders WHERE created < 100", "orders *"},
+        {"DELETE o FROM orders o JOIN users u ON o.user_id = u.user_id WHERE o.user_id IN (5, 6) AND u.user_id IN (5, 6)",
+         "o{5,6} u{5,6}"},
+        {"INSERT INTO users (user_id, name) VALUES (1, 'a'), (2, 'b'), (1, 'c')", "users{1,2}"},
+        {"INSERT INTO users (name, user_id) VALUES ('a', 'k1')", "users{'k1'}"},
+        {"INSERT INTO users (user_id, name) VALUES (1, 'a'), (@next, 'b')", "users *"},
+        {"INSERT INTO users (name) VALUES ('a')", "users *"},
+        {"INSERT INTO users VALUES (1, 'a')", "users *"},
+        {"SET @x = 1", ""},
+    };
+
+    MysqlParser::Parser parser;
+    ShardRouting routing;
+    size_t failures = 0;
+    for (const Case& c : cases) {
+        auto ast = parser.parse(c.sql);
+        if (!ast) {
+            std::cerr << "Failed to parse: " << c.sql << std::endl;
+            ++failures;
+            continue;
+        }
+        keys.extract(parser.getStatement(), routing);
+        std::string got = describe(routing);
+        ShardRouting from_tree;
+        keys.extract(ast.get(), from_tree);
+        if (got != c.expected || describe(from_tree) != got) {
+            std::cerr << "Mismatch: " << c.sql << "\n  expected '" << c.expected << "', got '" << got << "'" << std::endl;
+            ++failures;
+        }
+    }
+
+    // More values than the buffer holds: reported as spanning all shards
+    std::string wide = "SELECT name FROM users WHERE user_id IN (0";
+    for (size_t i = 1; i <= ShardRouting::kMaxValues; ++i) wide += ", " + std::to_string(i);
+    auto wide_ast = parser.parse(wide + ")");
+    keys.extract(parser.getStatement(), routing);
+    if (!wide_ast || !routing.truncated || !routing.spans_all_shards) {
+        std::cerr << "Overflowing IN list not reported as truncated" << std::endl;
+        ++failures;
+    }
+
+    const std::vector<std::string> workload = {
+        "SELECT name, email FROM users WHERE user_id = 42",
+        "SELECT o.id, o.total FROM orders o JOIN users u ON o.user_id = u.user_id WHERE u.user_id = 7 AND o.user_id = 7 AND o.total > 10",
+        "DELETE FROM orders WHERE user_id = 19 AND status = 'expired' LIMIT 100",
+        "SELECT name FROM users WHERE status = 'active' AND region = 'EU' AND user_id = 3",
+    };
+    std::vector<std::unique_ptr<AstNode>> trees;
+    for (const auto& q : workload) {
+        trees.push_back(parser.parse(q));
+        if (!trees.back()) {
+            std::cerr << "Failed to parse: " << q << std::endl;
+            return 1;
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    struct Cost { double ns; double allocations; };
+    size_t sink = 0;
+    auto measure = [&](auto&& route) {
+        size_t before = g_allocations.load();
+        auto start = clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            for (size_t i = 0; i < workload.size(); ++i) sink += route(i);
+        }
+        double n = static_cast<double>(iterations) * workload.size();
+        return Cost{std::chrono::duration<double, std::nano>(clock::now() - start).count() / n,
+                    static_cast<double>(g_allocations.load() - before) / n};
+    };
+    std::vector<MysqlParser::Statement> statements;
+    for (const auto& t : trees) statements.push_back(MysqlParser::statement_of(t.get()));
+
+    Cost parse = measure([&](size_t i) { return parser.parse(workload[i]) != nullptr; });
+    Cost walk = measure([&](size_t i) {
+        std::vector<std::string> values;
+        hand_written(trees[i].get(), values);
+        return values.size();
+    });
+    Cost extract = measure([&](size_t i) {
+        keys.extract(statements[i], routing);
+        return routing.value_count;
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Routing cases:      " << cases.size() + 1 << ", " << failures << " failures" << std::endl;
+    std::cout << "Parse:              " << parse.ns << " ns/statement, " << parse.allocations << " allocations" << std::endl;
+    std::cout << "Hand-written walk:  " << walk.ns << " ns/statement, " << walk.allocations << " allocations" << std::endl;
+    std::cout << "ShardKeySet:        " << extract.ns << " ns/statement, " << extract.allocations << " allocations" << std::endl;
+    std::cout << "(checksum " << sink % 10 << ")" << std::endl;
+    std::cout << "=======================\n";
+    return failures == 0 && extract.allocations == 0 ? 0 : 1;
+}
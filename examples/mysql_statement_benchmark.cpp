@@ -0,0 +1,141 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_statement.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::NodeType;
+using MysqlParser::Statement;
+using MysqlParser::StatementKind;
+
+// Parses a mixed workload and reports nodes per statement, then times finding
+// the WHERE, ORDER BY and LIMIT clauses of each statement three ways: by
+// scanning children, with statement_of(), and with Parser::getStatement()
+// recorded during the parse. Also checks that getStatement() and
+// statement_of() agree on every statement.
+// Usage: mysql_statement_benchmark [-i iterations]
+
+size_t count_nodes(const AstNode* node) {
+    if (!node) return 0;
+    size_t n = 1;
+    for (const AstNode* c : node->children) n += count_nodes(c);
+    return n;
+}
+
+const AstNode* scan_for(const AstNode* node, NodeType type) {
+    for (const AstNode* c : node->children) {
+        if (c && c->type == type) return c;
+    }
+    return nullptr;
+}
+
+const AstNode* const* clauses(const Statement& s, const AstNode* out[3]) {
+    switch (s.kind) {
+        case StatementKind::Select: out[0] = s.select.where; out[1] = s.select.order_by; out[2] = s.select.limit; break;
+        case StatementKind::Delete: out[0] = s.del.where; out[1] = s.del.order_by; out[2] = s.del.limit; break;
+        default: out[0] = out[1] = out[2] = nullptr; break;
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 200;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    std::vector<std::string> workload;
+    for (int i = 0; i < 500; ++i) {
+        std::string n = std::to_string(i);
+        workload.push_back("SELECT id, name FROM users WHERE id = " + n);
+        workload.push_back("SELECT 1");
+        workload.push_back("SELECT DISTINCT o.total FROM orders o WHERE o.user_id = " + n + " ORDER BY o.created_at DESC LIMIT 10");
+        workload.push_back("INSERT INTO audit_log (user_id, action) VALUES (" + n + ", 'login')");
+        workload.push_back("DELETE FROM sessions WHERE expires < " + n + " LIMIT 100");
+        workload.push_back("DELETE t1 FROM t1 JOIN t2 ON t1.id = t2.id WHERE t2.id = " + n);
+        workload.push_back("SET autocommit = 1, @request_id = " + n);
+        workload.push_back("SET NAMES utf8mb4");
+    }
+
+    MysqlParser::Parser parser;
+    std::vector<std::unique_ptr<AstNode>> trees;
+    std::vector<Statement> recorded;
+    size_t nodes = 0, mismatches = 0;
+    for (const auto& q : workload) {
+        auto ast = parser.parse(q);
+        if (!ast) {
+            std::cerr << "Failed to parse: " << q << std::endl;
+            return 1;
+        }
+        const Statement& s = parser.getStatement();
+        Statement viewed = MysqlParser::statement_of(ast.get());
+        if (s.kind != viewed.kind || s.node != ast.get() ||
+            std::memcmp(&s.select, &viewed.select, sizeof(s.select)) != 0 ||
+            std::memcmp(&s.insert, &viewed.insert, sizeof(s.insert)) != 0 ||
+            std::memcmp(&s.del, &viewed.del, sizeof(s.del)) != 0 ||
+            std::memcmp(&s.set, &viewed.set, sizeof(s.set)) != 0) {
+            std::cerr << "getStatement() and statement_of() disagree on: " << q << std::endl;
+            ++mismatches;
+        }
+        nodes += count_nodes(ast.get());
+        recorded.push_back(s);
+        trees.push_back(std::move(ast));
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto per_statement = [&](clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * trees.size());
+    };
+
+    size_t by_scan = 0, by_view = 0, by_recorded = 0;
+    auto start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& tree : trees) {
+            by_scan += (scan_for(tree.get(), NodeType::NODE_WHERE_CLAUSE) != nullptr) +
+                       (scan_for(tree.get(), NodeType::NODE_ORDER_BY_CLAUSE) != nullptr) +
+                       (scan_for(tree.get(), NodeType::NODE_LIMIT_CLAUSE) != nullptr);
+        }
+    }
+    double scan_ns = per_statement(start);
+
+    const AstNode* found[3];
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& tree : trees) {
+            clauses(MysqlParser::statement_of(tree.get()), found);
+            by_view += (found[0] != nullptr) + (found[1] != nullptr) + (found[2] != nullptr);
+        }
+    }
+    double view_ns = per_statement(start);
+
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const Statement& s : recorded) {
+            clauses(s, found);
+            by_recorded += (found[0] != nullptr) + (found[1] != nullptr) + (found[2] != nullptr);
+        }
+    }
+    double recorded_ns = per_statement(start);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Statements:              " << trees.size() << ", " << static_cast<double>(nodes) / trees.size()
+              << " nodes/statement" << std::endl;
+    std::cout << "Clauses by children scan: " << scan_ns << " ns/statement, " << by_scan / iterations << " found" << std::endl;
+    std::cout << "Clauses by statement_of:  " << view_ns << " ns/statement, " << by_view / iterations << " found" << std::endl;
+    std::cout << "Clauses by getStatement:  " << recorded_ns << " ns/statement, " << by_recorded / iterations << " found" << std::endl;
+    std::cout << "View mismatches:          " << mismatches << std::endl;
+    std::cout << "=======================\n";
+    return (mismatches == 0 && by_scan == by_view && by_view == by_recorded) ? 0 : 1;
+}
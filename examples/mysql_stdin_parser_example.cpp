@@ -1,5 +1,5 @@
 #include "mysql_parser/mysql_parser.h" // Ensure this path is correct
-#include "mysql_parser/mysql_ast.h"    // Ensure this path is correct
+#include "mysql_parser/mysql_ast_print.h" // For MysqlParser::print_ast
 #include <iostream>
 #include <vector>
 #include <string>
@@ -0,0 +1,171 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_symbol_table.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::NodeType;
+using MysqlParser::Symbol;
+using MysqlParser::kNoSymbol;
+
+// Parses a workload whose statements keep naming the same tables, columns and
+// variables, with and without a shared SymbolTable, then times a downstream
+// pass that checks every name against a watch list: by string lookup in an
+// unordered_set, and by indexing a flag array with the symbol. Finally
+// several threads parse with one shared table and must agree on every symbol.
+// Usage: mysql_symbol_table_benchmark [-i iterations] [-t threads]
+
+template <typename F>
+void walk(const AstNode* node, F&& f) {
+    std::vector<const AstNode*> stack{node};
+    while (!stack.empty()) {
+        const AstNode* n = stack.back();
+        stack.pop_back();
+        f(n);
+        for (const AstNode* c : n->children) {
+            if (c) stack.push_back(c);
+        }
+    }
+}
+
+bool is_named(const AstNode* n) {
+    return n->type == NodeType::NODE_IDENTIFIER || n->type == NodeType::NODE_SYSTEM_VARIABLE ||
+           n->type == NodeType::NODE_USER_VARIABLE;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 20;
+    size_t threads = 4;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else if (arg == "-t" && i + 1 < argc) {
+            threads = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    std::vector<std::string> workload;
+    for (int i = 0; i < 2000; ++i) {
+        std::string n = std::to_string(i);
+        workload.push_back("SELECT u.id, u.name, o.order_total FROM users u JOIN orders o ON u.id = o.user_id WHERE u.id = " + n + ";");
+        workload.push_back("INSERT INTO audit_log (user_id, action, created_at) VALUES (" + n + ", 'login', NOW());");
+        workload.push_back("SET @@session.sql_mode = 'TRADITIONAL', autocommit = 1, @request_id = " + n + ";");
+        workload.push_back("SELECT COUNT(*) FROM orders WHERE customer_reference = 'c" + n + "' ORDER BY created_at DESC LIMIT 10;");
+    }
+    const std::vector<std::string> watched = {"users", "orders", "sql_mode", "customer_reference"};
+
+    using clock = std::chrono::steady_clock;
+    auto parse_all = [&](MysqlParser::Parser& parser, std::vector<std::unique_ptr<AstNode>>& out) {
+        out.clear();
+        auto start = clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            for (const auto& q : workload) {
+                auto ast = parser.parse(q);
+                if (it == 0) out.push_back(std::move(ast));
+            }
+        }
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * workload.size());
+    };
+
+    MysqlParser::Parser plain;
+    std::vector<std::unique_ptr<AstNode>> plain_trees;
+    parse_all(plain, plain_trees); // Warm up
+    double plain_ns = parse_all(plain, plain_trees);
+
+    MysqlParser::SymbolTable symbols;
+    MysqlParser::Parser interning;
+    interning.setSymbolTable(&symbols);
+    std::vector<std::unique_ptr<AstNode>> symbol_trees;
+    parse_all(interning, symbol_trees);
+    double interning_ns = parse_all(interning, symbol_trees);
+
+    // Downstream: count references to watched names among the named nodes
+    auto named_nodes = [](const std::vector<std::unique_ptr<AstNode>>& trees) {
+        std::vector<const AstNode*> out;
+        for (const auto& tree : trees) {
+            if (tree) walk(tree.get(), [&](const AstNode* n) { if (is_named(n)) out.push_back(n); });
+        }
+        return out;
+    };
+    std::vector<const AstNode*> plain_named = named_nodes(plain_trees);
+    std::vector<const AstNode*> symbol_named = named_nodes(symbol_trees);
+    std::unordered_set<std::string> watched_names(watched.begin(), watched.end());
+    std::vector<uint8_t> watched_symbols(symbols.size() + 1, 0); // Indexed by symbol
+    for (const auto& w : watched) {
+        Symbol s = symbols.find(w);
+        if (s) watched_symbols[s] = 1;
+    }
+
+    size_t by_string = 0, by_symbol = 0;
+    auto start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const AstNode* n : plain_named) by_string += watched_names.count(n->value);
+    }
+    double string_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * plain_named.size());
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const AstNode* n : symbol_named) by_symbol += n->symbol < watched_symbols.size() && watched_symbols[n->symbol];
+    }
+    double symbol_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * symbol_named.size());
+
+    // Shared table: every thread must see the same symbol for the same name
+    MysqlParser::SymbolTable shared;
+    std::vector<std::vector<Symbol>> seen(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            MysqlParser::Parser parser;
+            parser.setSymbolTable(&shared);
+            for (size_t i = t; i < workload.size(); i += threads) {
+                auto ast = parser.parse(workload[i]);
+                if (ast) walk(ast.get(), [&](const AstNode* n) { if (n->symbol) seen[t].push_back(n->symbol); });
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    size_t mismatches = 0, named = 0;
+    for (const auto& v : seen) {
+        named += v.size();
+        for (Symbol s : v) {
+            if (shared.find(shared.name(s)) != s) ++mismatches;
+        }
+    }
+
+    // A full table interns a mixed-case name together with its folded form, or not at all
+    MysqlParser::SymbolTableOptions tiny_options;
+    tiny_options.max_symbols = 2;
+    MysqlParser::SymbolTable tiny(tiny_options);
+    Symbol ids = tiny.intern("ids");
+    Symbol users_upper = tiny.intern("Users"); // "users" takes the last slot
+    Symbol orders_upper = tiny.intern("Orders");
+    bool full_ok = ids && users_upper == kNoSymbol && orders_upper == kNoSymbol && tiny.size() == 2 &&
+                   tiny.folded(tiny.find("users")) == tiny.find("users");
+    MysqlParser::SymbolTable roomy(tiny_options);
+    Symbol users = roomy.intern("Users");
+    full_ok = full_ok && users && roomy.folded(users) == roomy.find("users") && roomy.intern("x") == kNoSymbol;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Parse without symbols:   " << plain_ns << " ns/statement" << std::endl;
+    std::cout << "Parse with SymbolTable:  " << interning_ns << " ns/statement (" << symbols.size() << " symbols)" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "Watch list by string:    " << string_ns << " ns/name, " << by_string / iterations << " hits" << std::endl;
+    std::cout << "Watch list by symbol:    " << symbol_ns << " ns/name, " << by_symbol / iterations << " hits" << std::endl;
+    std::cout << "Shared table, " << threads << " threads: " << named << " named nodes, " << shared.size()
+              << " symbols, " << mismatches << " mismatches" << std::endl;
+    std::cout << "Full table folding:      " << (full_ok ? "ok" : "FAILED") << std::endl;
+    std::cout << "=======================\n";
+    return (by_string == by_symbol && by_string > 0 && mismatches == 0 && full_ok) ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_query_comments.h"
+#include "mysql_parser/mysql_session_state.h"
+#include "mysql_parser/mysql_statement.h"
+#include "mysql_parser/mysql_token_buffer.h"
+#include "counting_allocator.h" // Counts heap allocations, to show that a warm buffer does not grow
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <strings.h>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::QueryComments;
+using MysqlParser::TokenBuffer;
+
+// Checks that parsing a TokenBuffer gives exactly what parsing the text
+// gives (tree, status, errors, digest, comments, statement kind, session
+// changes), with and without tight limits, over a corpus plus any files given
+// with -f (one statement per line). Then times a four-pass pipeline
+// (classification, digest, hints, AST) run the old way, as one parse per
+// pass, and with the query lexed once into a reused TokenBuffer.
+// Usage: mysql_token_buffer_benchmark [-i iterations] [-f file]...
+
+bool same_tree(const AstNode* a, const AstNode* b) {
+    if (!a || !b) return a == b;
+    if (a->type != b->type || a->value != b->value || a->escaped != b->escaped || a->symbol != b->symbol ||
+        a->children.size() != b->children.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a->children.size(); ++i) {
+        if (!same_tree(a->children[i], b->children[i])) return false;
+    }
+    return true;
+}
+
+bool same_comments(const QueryComments& a, const QueryComments& b) {
+    if (a.comments.size() != b.comments.size() || a.annotations.size() != b.annotations.size()) return false;
+    for (size_t i = 0; i < a.comments.size(); ++i) {
+        if (a.comments[i].offset != b.comments[i].offset || a.comments[i].length != b.comments[i].length ||
+            a.comments[i].kind != b.comments[i].kind) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.annotations.size(); ++i) {
+        if (a.annotations[i].key_offset != b.annotations[i].key_offset ||
+            a.annotations[i].value_offset != b.annotations[i].value_offset ||
+            a.annotations[i].value_length != b.annotations[i].value_length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The classification pass: the statement's first keyword, from the tokens
+enum class Verb { Select, Insert, Delete, Set, Transaction, Other };
+
+Verb classify(const TokenBuffer& tokens) {
+    if (tokens.empty()) return Verb::Other;
+    std::string_view first = tokens.text(tokens[0]);
+    auto is = [&](const char* word) { return first.size() == strlen(word) && strncasecmp(first.data(), word, first.size()) == 0; };
+    if (is("SELECT")) return Verb::Select;
+    if (is("INSERT")) return Verb::Insert;
+    if (is("DELETE")) return Verb::Delete;
+    if (is("SET")) return Verb::Set;
+    if (is("BEGIN") || is("COMMIT")) return Verb::Transaction;
+    return Verb::Other;
+}
+
+// The same, from a parse of the text
+Verb classify(const MysqlParser::Statement& s, const AstNode* tree) {
+    switch (s.kind) {
+        case MysqlParser::StatementKind::Select: return Verb::Select;
+        case MysqlParser::StatementKind::Insert: return Verb::Insert;
+        case MysqlParser::StatementKind::Delete: return Verb::Delete;
+        case MysqlParser::StatementKind::Set: return Verb::Set;
+        default: break;
+    }
+    return tree && (tree->type == MysqlParser::NodeType::NODE_BEGIN_STATEMENT ||
+                    tree->type == MysqlParser::NodeType::NODE_COMMIT_STATEMENT) ? Verb::Transaction : Verb::Other;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 50;
+    std::vector<std::string> corpus = {
+        "SELECT id, name FROM users WHERE id = 42",
+        "select `select`, `a``b` FROM `my table` WHERE `where` = \"it\"\"s\"",
+        "SELECT a FROM t WHERE b = 'x\\'y\\n' AND c = 'it''s' AND d = '50\\%' AND e = X'1F'",
+        "SELECT /*+ MAX_EXECUTION_TIME(10) */ a FROM t /* hostgroup=2, shard=\"eu\" */ WHERE b = 1 -- trailing",
+        "SELECT a FROM t # trailing hostgroup=3",
+        "SELECT caf\xC3\xA9, COUNT(*) FROM t GROUP BY caf\xC3\xA9 HAVING COUNT(*) > 1 ORDER BY 2 DESC LIMIT 10",
+        "SELECT DISTINCT o.total FROM orders o JOIN users u ON o.user_id = u.id WHERE o.total >= 1.5e3 FOR UPDATE",
+        "INSERT INTO audit_log (user_id, action, note) VALUES (1, 'login', \"ok\"), (2, 'logout', 'bye')",
+        "DELETE FROM sessions WHERE expires < 100 ORDER BY expires LIMIT 10",
+        "SET autocommit = 1, @request_id = 'abc', @@session.sql_mode = 'TRADITIONAL'",
+        "SET NAMES utf8mb4 COLLATE utf8mb4_bin",
+        "SET TRANSACTION ISOLATION LEVEL READ COMMITTED",
+        "BEGIN",
+        "COMMIT;",
+        "SHOW DATABASES",
+        "QUIT",
+        "",
+        ";",
+        "/* only a comment */",
+        "SELECT a FROM t WHERE b = 'unterminated",
+        "SELECT a FROM t WHERE b = \"unterminated",
+        "SELECT a FROM `unterminated",
+        "SELECT a FROM `new\nline` WHERE b = 1",
+        "SELECT a FROM t /* unterminated",
+        "SELECT a FROM t WHERE b = 1 $ AND c = 2",
+        "SELECT a FROM t WHERE b = \xFF\xFE",
+        "SELECT FROM t WHERE /* after the error */ b = 'x' $",
+        "SELECT a FROM t WHERE b = 1; SELECT 2",
+        "SELECT ((((((a)))))) FROM t",
+        "INSERT INTO t VALUES ('a', 'b', 'c', 'd', 'e', 'f')",
+        // Strings in each quoting start condition, with every escape form
+        "SELECT 'a\\tb\\rc\\bd\\0e\\Zf\\\\g\\qh', \"a\\\"b\\'c\\%d\\_e\", '', \"\", '''', \"\"\"\"",
+        "SELECT 'multi\nline', \"tab\there\", 'backslash\\\nnewline'",
+        "SELECT 'don''t', \"say \"\"hi\"\"\", `x``y` FROM `t` WHERE `a b` = 'c''d' AND \"e\" = 'f'",
+        "SELECT 'a' 'b', \"/* not a comment */\", '-- nor this', `# or this` FROM t",
+        "SELECT '\xC3\xA9t\xC3\xA9', `caf\xC3\xA9` FROM t",
+        // Comments of every kind, between and inside statements
+        "/* lead */ SELECT /* a */ a /**/, /* ** * */ b -- c\nFROM t # d\nWHERE e = 1 /* multi\nline */",
+        "SELECT /*+ BKA(t) */ /*! STRAIGHT_JOIN */ a FROM t -- hostgroup=5\n",
+        "SELECT a FROM t --not a comment",
+        "SELECT 1 /* a = 'b' \"c\" `d` */ + 2",
+        // Lexer errors, alone and mixed with other tokens
+        "SELECT 'unterminated \\",
+        "SELECT 'it''s",
+        "SELECT a FROM `t``",
+        "SELECT a /* unterminated * /",
+        "SELECT a FROM t WHERE b = 1 $ AND c = 'x' \\ d",
+        "SELECT \xC3 FROM t",
+        "SELECT a FROM t WHERE b = '\xFF' AND c = \xE2\x82",
+        "SELECT `a\nb`, 'ok' FROM t /* after */ LIMIT 1",
+        // LIMIT and OFFSET forms
+        "SELECT message FROM messages ORDER BY created_at DESC LIMIT 10 OFFSET 5",
+        "SELECT a FROM t LIMIT 5, 10",
+        "SELECT a FROM t LIMIT 0 OFFSET 0;",
+        "SELECT a FROM t WHERE b IN (1, 2) LIMIT 10 OFFSET",
+        "SELECT `offset`, `limit` FROM t LIMIT 1 OFFSET 2",
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else if (arg == "-f" && i + 1 < argc) {
+            std::ifstream in(argv[++i]);
+            if (!in) {
+                std::cerr << "Cannot read " << argv[i] << std::endl;
+                return 1;
+            }
+            for (std::string line; std::getline(in, line);) {
+                if (!line.empty()) corpus.push_back(line);
+            }
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    // The fast path never sees a TokenBuffer, so compare against the grammar
+    MysqlParser::Parser text_parser, token_parser;
+    text_parser.setFastPath(false);
+    MysqlParser::SessionState text_session, token_session;
+    text_parser.setSessionState(&text_session);
+    token_parser.setSessionState(&token_session);
+    TokenBuffer tokens;
+
+    size_t mismatches = 0, checks = 0;
+    auto check = [&](const std::string& q, const MysqlParser::ParseLimits* limits) {
+        tokens.lex(q);
+        auto a = limits ? text_parser.parse(q, *limits) : text_parser.parse(q);
+        auto b = limits ? token_parser.parse(tokens, *limits) : token_parser.parse(tokens);
+        std::string what;
+        if (!same_tree(a.get(), b.get())) what += " tree";
+        if (text_parser.getStatus() != token_parser.getStatus()) what += " status";
+        if (text_parser.getErrors() != token_parser.getErrors()) what += " errors";
+        if (text_parser.getDigest() != token_parser.getDigest()) what += " digest";
+        if (!same_comments(text_parser.getComments(), token_parser.getComments())) what += " comments";
+        if (text_parser.getStatement().kind != token_parser.getStatement().kind) what += " statement";
+        if (text_session != token_session) what += " session";
+        if (!limits && a && tokens.getDigest() != text_parser.getDigest()) what += " buffer-digest";
+        if (!limits && a && !same_comments(tokens.getComments(), text_parser.getComments())) what += " buffer-comments";
+        if (!what.empty()) {
+            std::cerr << "Mismatch (" << what.substr(1) << (limits ? ", with limits" : "") << "): " << q << std::endl;
+            ++mismatches;
+        }
+        ++checks;
+    };
+    for (const auto& q : corpus) {
+        check(q, nullptr);
+        for (size_t n = 1; n <= 12; ++n) {
+            MysqlParser::ParseLimits limits;
+            limits.max_tokens = n;
+            check(q, &limits);
+            limits = MysqlParser::ParseLimits();
+            limits.max_nodes = n;
+            check(q, &limits);
+        }
+        MysqlParser::ParseLimits depth;
+        depth.max_depth = 2;
+        check(q, &depth);
+    }
+
+    // The pipeline: four views of each statement
+    std::vector<std::string> workload;
+    for (int i = 0; i < 200; ++i) {
+        std::string n = std::to_string(i);
+        workload.push_back("SELECT /*+ MAX_EXECUTION_TIME(100) */ id, name, email FROM users WHERE id = " + n);
+        workload.push_back("SELECT o.id, o.total FROM orders o JOIN users u ON o.user_id = u.id WHERE u.region = 'EU' ORDER BY o.total DESC LIMIT 20");
+        workload.push_back("INSERT INTO audit_log (user_id, action, created_at) VALUES (" + n + ", 'login', '2024-01-01')");
+        workload.push_back("/* hostgroup=2 */ DELETE FROM sessions WHERE expires < " + n + " LIMIT 100");
+        workload.push_back("SET autocommit = 1, @request_id = " + n);
+    }
+    using clock = std::chrono::steady_clock;
+    auto per_statement = [&](clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count() / (iterations * workload.size());
+    };
+    size_t sink = 0;
+    MysqlParser::Parser parser;
+    parser.setFastPath(false); // Both ways go through the grammar
+
+    // Each pass runs the scanner again, as each needs its own parse today
+    auto start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& q : workload) {
+            auto t1 = parser.parse(q);
+            sink += static_cast<size_t>(classify(parser.getStatement(), t1.get()));
+            parser.parse(q);
+            sink += parser.getDigest() & 1;
+            parser.parse(q);
+            sink += parser.getComments().hasHints();
+            auto ast = parser.parse(q);
+            sink += ast != nullptr;
+        }
+    }
+    double reparse_ns = per_statement(start);
+
+    for (const auto& q : workload) tokens.lex(q); // Warm the buffer up to the longest statement
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& q : workload) {
+            tokens.lex(q);
+            sink += static_cast<size_t>(classify(tokens));
+            sink += tokens.getDigest() & 1;
+            sink += tokens.getComments().hasHints();
+            auto ast = parser.parse(tokens);
+            sink += ast != nullptr;
+        }
+    }
+    double buffer_ns = per_statement(start);
+
+    size_t allocations_before = g_allocations.load();
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& q : workload) tokens.lex(q);
+    }
+    double lex_ns = per_statement(start);
+    double lex_allocations = static_cast<double>(g_allocations.load() - allocations_before) / (iterations * workload.size());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Differential checks:        " << checks << " (" << corpus.size() << " statements), "
+              << mismatches << " mismatches" << std::endl;
+    std::cout << "Four passes, one parse each: " << reparse_ns << " ns/statement" << std::endl;
+    std::cout << "Four passes, lexed once:     " << buffer_ns << " ns/statement (" << reparse_ns / buffer_ns << "x)" << std::endl;
+    std::cout << "TokenBuffer::lex alone:      " << lex_ns << " ns/statement, " << lex_allocations
+              << " allocations (the scanner's identifier and literal strings)" << std::endl;
+    std::cout << "(checksum " << sink % 10 << ")" << std::endl;
+    std::cout << "=======================\n";
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include "mysql_parser/mysql_parser.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+// Parses the same statement shapes with ASCII identifiers and with
+// multi-byte UTF-8 identifiers (Cyrillic, Greek, CJK, accented Latin), then
+// a corpus with malformed bytes to show that each bad run yields one error.
+// Like unknown characters, malformed bytes are reported in getErrors() and
+// skipped; they do not fail the parse by themselves. The fast path is off,
+// so every statement goes through the scanner; each corpus is timed -r times,
+// alternating, and the fastest round is reported.
+// Usage: mysql_utf8_identifiers_benchmark [-n statements] [-r rounds]
+
+const std::vector<std::string> kAsciiNames = {
+    "customers", "order_total", "first_name", "city", "amount", "created_at", "product", "region"
+};
+const std::vector<std::string> kUnicodeNames = {
+    "клиенты", "сумма_заказа", "prénom", "città", "ποσό", "创建时间", "商品", "지역"
+};
+
+std::string make_statement(const std::vector<std::string>& names, size_t i) {
+    auto n = [&](size_t k) -> const std::string& { return names[(i + k) % names.size()]; };
+    switch (i % 4) {
+        case 0:
+            return "SELECT " + n(1) + ", " + n(2) + " FROM " + n(0) + " WHERE " + n(3) + " = 'x' ORDER BY " + n(4) + ";";
+        case 1:
+            return "INSERT INTO " + n(0) + " (" + n(1) + ", " + n(2) + ") VALUES (1, 'a'), (2, 'b');";
+        case 2:
+            return "SELECT " + n(5) + ".a, COUNT(*) FROM " + n(5) + " JOIN " + n(6) + " ON " + n(5) + ".id = " + n(6) + ".id GROUP BY " + n(7) + ";";
+        default:
+            return "DELETE FROM " + n(0) + " WHERE " + n(1) + " < 100 LIMIT 10;";
+    }
+}
+
+struct RunResult {
+    double ns_per_statement;
+    double mb_per_s;
+    size_t failed;
+    size_t errors;
+};
+
+RunResult run(MysqlParser::Parser& parser, const std::vector<std::string>& corpus) {
+    using clock = std::chrono::high_resolution_clock;
+    size_t bytes = 0, failed = 0, errors = 0;
+    auto start = clock::now();
+    for (const auto& q : corpus) {
+        auto ast = parser.parse(q);
+        if (!ast) failed++;
+        errors += parser.getErrors().size();
+        bytes += q.size();
+    }
+    double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    return RunResult{ns / corpus.size(), bytes / (ns / 1e9) / 1e6, failed, errors};
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = 100000;
+    int rounds = 5;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            n = std::stoul(argv[++i]);
+        } else if (arg == "-r" && i + 1 < argc) {
+            rounds = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+    if (n == 0) n = 1;
+    if (rounds <= 0) rounds = 1;
+
+    std::vector<std::string> ascii, unicode, malformed;
+    for (size_t i = 0; i < n; ++i) {
+        ascii.push_back(make_statement(kAsciiNames, i));
+        unicode.push_back(make_statement(kUnicodeNames, i));
+    }
+    // Malformed runs: stray continuation bytes, a truncated 3-byte sequence,
+    // invalid lead bytes, and a 4-byte character (outside what MySQL allows unquoted)
+    const std::vector<std::string> bad_runs = {"\x80\x80\x80\x80", "\xE4\xB8", "\xFF\xFE\xFD", "\xF0\x9F\x98\x80"};
+    for (size_t i = 0; i < n / 10 + 1; ++i) {
+        malformed.push_back("SELECT a FROM t" + bad_runs[i % bad_runs.size()] + " WHERE b = 1;");
+    }
+
+    MysqlParser::Parser parser;
+    parser.setFastPath(false); // It leaves non-ASCII names to the scanner anyway
+
+    // Each name comes back as one identifier, byte for byte
+    size_t name_mismatches = 0;
+    for (size_t i = 0; i < kUnicodeNames.size(); ++i) {
+        const std::string& name = kUnicodeNames[i];
+        auto ast = parser.parse("SELECT " + name + " FROM " + kUnicodeNames[(i + 1) % kUnicodeNames.size()]);
+        const MysqlParser::AstNode* item = ast ? ast->children[0]->children[0]->children[0] : nullptr;
+        if (!item || item->type != MysqlParser::NodeType::NODE_IDENTIFIER || item->value != name ||
+            !parser.getErrors().empty()) {
+            std::cerr << "Identifier not lexed as one name: " << name << std::endl;
+            ++name_mismatches;
+        }
+    }
+
+    run(parser, ascii); // Warm up
+    RunResult a = run(parser, ascii);
+    RunResult u = run(parser, unicode);
+    for (int r = 1; r < rounds; ++r) {
+        RunResult ra = run(parser, ascii);
+        RunResult ru = run(parser, unicode);
+        if (ra.ns_per_statement < a.ns_per_statement) a = ra;
+        if (ru.ns_per_statement < u.ns_per_statement) u = ru;
+    }
+    RunResult m = run(parser, malformed);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "ASCII identifiers:   " << a.ns_per_statement << " ns/statement, " << a.mb_per_s << " MB/s, "
+              << a.failed << " failed" << std::endl;
+    std::cout << "UTF-8 identifiers:   " << u.ns_per_statement << " ns/statement, " << u.mb_per_s << " MB/s, "
+              << u.failed << " failed" << std::endl;
+    std::cout << "Malformed UTF-8:     " << malformed.size() << " statements, "
+              << std::setprecision(2) << static_cast<double>(m.errors) / malformed.size() << " errors/statement"
+              << std::endl;
+    std::cout << "Identifier checks:   " << kUnicodeNames.size() << ", " << name_mismatches << " mismatches" << std::endl;
+    std::cout << "=======================\n";
+    return (a.failed == 0 && u.failed == 0 && m.errors == malformed.size() && name_mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_ast_visitor.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>    // Required for timing
+#include <iomanip>   // Required for std::fixed and std::setprecision
+
+using MysqlParser::AstNode;
+using MysqlParser::NodeType;
+using MysqlParser::NodeTag;
+using MysqlParser::VisitAction;
+
+// A typical rewrite-rule pass: count rows of VALUES clauses, calls to
+// selected functions, SET assignments and table references. It is run
+// twice over the same trees: once in the old style (recursive switch plus
+// string compares on NODE_EXPRESSION_PLACEHOLDER tags) against trees
+// converted back to the old representation, and once with AstVisitor.
+struct RuleStats {
+    size_t value_rows = 0;
+    size_t hot_function_calls = 0;
+    size_t assignments = 0;
+    size_t table_refs = 0;
+
+    size_t checksum() const { return value_rows * 1000003 + hot_function_calls * 10007 + assignments * 101 + table_refs; }
+};
+
+// --- Before: string-tagged placeholders ---
+
+// Rewrites dedicated node types back to the pre-visitor placeholder encoding
+void to_legacy(AstNode* node) {
+    if (!node) return;
+    switch (node->type) {
+        case NodeType::NODE_EXPRESSION_LIST:
+            node->type = NodeType::NODE_EXPRESSION_PLACEHOLDER; node->value = "expr_list_wrapper"; break;
+        case NodeType::NODE_VALUE_ROW_LIST:
+            node->type = NodeType::NODE_EXPRESSION_PLACEHOLDER; node->value = "value_row_list_wrapper"; break;
+        case NodeType::NODE_VALUES_CLAUSE:
+            node->type = NodeType::NODE_EXPRESSION_PLACEHOLDER; node->value = "VALUES_CLAUSE"; break;
+        case NodeType::NODE_VARIABLE_ASSIGNMENT_LIST:
+            node->type = NodeType::NODE_EXPRESSION_PLACEHOLDER; node->value = "set_var_assignments_list"; break;
+        case NodeType::NODE_FUNCTION_CALL:
+            node->type = NodeType::NODE_EXPRESSION_PLACEHOLDER; node->value = "FUNC_CALL:" + node->value; break;
+        default: break;
+    }
+    for (AstNode* child : node->children) to_legacy(child);
+}
+
+void legacy_walk(const AstNode* node, RuleStats& stats) {
+    if (!node) return;
+    switch (node->type) {
+        case NodeType::NODE_EXPRESSION_PLACEHOLDER:
+            if (node->value == "value_row_list_wrapper") {
+                stats.value_rows += node->children.size();
+            } else if (node->value.compare(0, 10, "FUNC_CALL:") == 0) {
+                if (node->value == "FUNC_CALL:NOW" || node->value == "FUNC_CALL:UUID" || node->value == "FUNC_CALL:RAND") {
+                    stats.hot_function_calls++;
+                }
+            } else if (node->value == "set_var_assignments_list") {
+                stats.assignments += node->children.size();
+            }
+            break;
+        case NodeType::NODE_TABLE_REFERENCE:
+            stats.table_refs++;
+            break;
+        default:
+            break;
+    }
+    for (const AstNode* child : node->children) {
+        legacy_walk(child, stats);
+    }
+}
+
+// --- After: AstVisitor with dedicated node types ---
+
+struct RuleVisitor : MysqlParser::AstVisitor<RuleVisitor> {
+    RuleStats stats;
+
+    VisitAction visit(NodeTag<NodeType::NODE_VALUE_ROW_LIST>, const AstNode& node) {
+        stats.value_rows += node.children.size();
+        return VisitAction::Continue;
+    }
+    VisitAction visit(NodeTag<NodeType::NODE_FUNCTION_CALL>, const AstNode& node) {
+        if (node.value == "NOW" || node.value == "UUID" || node.value == "RAND") {
+            stats.hot_function_calls++;
+        }
+        return VisitAction::Continue;
+    }
+    VisitAction visit(NodeTag<NodeType::NODE_VARIABLE_ASSIGNMENT_LIST>, const AstNode& node) {
+        stats.assignments += node.children.size();
+        return VisitAction::Continue;
+    }
+    VisitAction visit(NodeTag<NodeType::NODE_TABLE_REFERENCE>, const AstNode&) {
+        stats.table_refs++;
+        return VisitAction::Continue;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    int iterations = 200000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    const std::vector<std::string> queries = {
+        "SELECT c.name, o.order_id FROM customers c JOIN orders o ON c.customer_id = o.customer_id WHERE o.created > NOW();",
+        "SELECT name FROM users WHERE id = 42;",
+        "INSERT INTO events (id, ts, tag) VALUES (UUID(), NOW(), 'a'), (UUID(), NOW(), 'b'), (UUID(), NOW(), 'c');",
+        "SET @a = 1, @b = 'two', global max_heap_table_size = 128000000;",
+        "SELECT dt.category_name, dt.total_sales FROM (SELECT category, SUM(sales_amount) AS total_sales FROM sales GROUP BY category) AS dt WHERE dt.total_sales > 10000;",
+        "DELETE FROM t1, t2 USING table1 AS t1 INNER JOIN table2 AS t2 ON t1.key = t2.key WHERE t1.value > RAND();",
+        "SELECT COALESCE(a, b), CONCAT(x, y, z) FROM t WHERE f(g(h(1))) = 2 ORDER BY id DESC LIMIT 10;"
+    };
+
+    MysqlParser::Parser parser;
+    std::vector<std::unique_ptr<AstNode>> trees;
+    std::vector<std::unique_ptr<AstNode>> legacy_trees;
+    for (const auto& q : queries) {
+        auto ast = parser.parse(q);
+        auto legacy = parser.parse(q);
+        if (!ast || !legacy) {
+            std::cerr << "Failed to parse: " << q << std::endl;
+            return 1;
+        }
+        to_legacy(legacy.get());
+        trees.push_back(std::move(ast));
+        legacy_trees.push_back(std::move(legacy));
+    }
+
+    using clock = std::chrono::high_resolution_clock;
+
+    RuleStats legacy_stats;
+    auto start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& tree : legacy_trees) legacy_walk(tree.get(), legacy_stats);
+    }
+    std::chrono::duration<double> legacy_time = clock::now() - start;
+
+    RuleVisitor visitor;
+    start = clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& tree : trees) visitor.walk(tree.get());
+    }
+    std::chrono::duration<double> visitor_time = clock::now() - start;
+
+    double walks = static_cast<double>(iterations) * trees.size();
+    std::cout << "\n======= SUMMARY =======\n";
+    std::cout << "Tree walks: " << static_cast<long long>(walks) << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Switch + string tags: " << legacy_time.count() * 1e9 / walks << " ns/walk" << std::endl;
+    std::cout << "AstVisitor:           " << visitor_time.count() * 1e9 / walks << " ns/walk" << std::endl;
+    std::cout << "Results match: " << (legacy_stats.checksum() == visitor.stats.checksum() ? "yes" : "NO") << std::endl;
+    std::cout << "=======================\n";
+    return legacy_stats.checksum() == visitor.stats.checksum() ? 0 : 1;
+}
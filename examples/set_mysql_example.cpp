@@ -1,4 +1,5 @@
 #include "mysql_parser/mysql_parser.h" // Ensure this path is correct for your include setup
+#include "mysql_parser/mysql_ast_print.h" // For MysqlParser::print_ast
 #include <iostream>
 #include <vector>
 #include <string>
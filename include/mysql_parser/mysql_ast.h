@@ -3,8 +3,9 @@
 
 #include <string>
 #include <vector>
-#include <iostream>
-#include <algorithm> // For std::move if not implicitly included by <string> or <vector>
+#include <utility> // For std::move
+#include <cstddef>
+#include <cstdint>
 
 namespace MysqlParser {
 
@@ -24,7 +25,7 @@ enum class NodeType {
     NODE_USER_VARIABLE,         // e.g., @my_var
     NODE_SYSTEM_VARIABLE,       // e.g., @@global.var
     NODE_VARIABLE_SCOPE,        // GLOBAL, SESSION, PERSIST, etc.
-    NODE_EXPRESSION_PLACEHOLDER,// Placeholder for more complex expressions (and functions)
+    NODE_EXPRESSION_PLACEHOLDER,// No longer produced by the grammar (see NODE_EXPRESSION_LIST and below)
     NODE_SIMPLE_EXPRESSION,     // More specific expression type
     NODE_AGGREGATE_FUNCTION_CALL, // For COUNT, SUM, AVG etc.
     NODE_SET_NAMES,
@@ -97,27 +98,45 @@ enum class NodeType {
 
     // Added for IS NULL / IS NOT NULL
     NODE_IS_NULL_EXPRESSION,
-    NODE_IS_NOT_NULL_EXPRESSION
+    NODE_IS_NOT_NULL_EXPRESSION,
+
+    // Formerly NODE_EXPRESSION_PLACEHOLDER nodes told apart by their value string
+    NODE_EXPRESSION_LIST,       // Comma-separated expressions (function args, one VALUES row)
+    NODE_VALUE_ROW_LIST,        // Rows of a VALUES clause
+    NODE_VALUES_CLAUSE,         // VALUES (...), (...)
+    NODE_VARIABLE_ASSIGNMENT_LIST, // SET a = 1, @b = 2
+    NODE_TXN_CHARACTERISTIC_LIST,  // SET TRANSACTION characteristics
+    NODE_TXN_ISOLATION_LEVEL,   // ISOLATION LEVEL <level>
+    NODE_MATCH_AGAINST_EXPRESSION, // MATCH (cols) AGAINST (expr [modifier])
+    NODE_FUNCTION_CALL,         // name(args); value holds the function name
+    NODE_IN_EXPRESSION,         // expr [NOT] IN (list); value is "IN" or "NOT IN"
+
+    NODE_TYPE_COUNT             // Number of node types; must stay last
 };
 
+constexpr size_t kNodeTypeCount = static_cast<size_t>(NodeType::NODE_TYPE_COUNT);
+
 // Structure for an AST Node
 struct AstNode {
     NodeType type;
     std::string value; // Stores identifier name, literal value, operator type, etc.
     std::vector<AstNode*> children;
+    bool escaped = false; // True if value was unescaped from a quoted literal (differs from the source text)
+    // Interned name of identifier, variable, alias and function-call nodes when
+    // the parser has a SymbolTable (see mysql_symbol_table.h); 0 otherwise
+    uint32_t symbol = 0;
 
     // Constructor
     AstNode(NodeType t, const std::string& val = "") : type(t), value(val) {}
     // Move constructor for value
     AstNode(NodeType t, std::string&& val) : type(t), value(std::move(val)) {}
 
-    // Destructor to clean up children
-    ~AstNode() {
-        for (AstNode* child : children) {
-            delete child;
-        }
-        children.clear();
-    }
+    // Destructor to clean up children. Iterative, so that tearing down a
+    // deeply nested tree uses constant stack: descendants are detached into
+    // a work list and deleted once their own children have been taken.
+    // Out of line (mysql_ast.cpp), so that teardown shows up in profiles as
+    // its own symbol and carries the teardown_* tracepoints.
+    ~AstNode();
 
     // Prevent copying and assignment to manage memory explicitly
     AstNode(const AstNode&) = delete;
@@ -133,102 +152,6 @@ struct AstNode {
     }
 };
 
-// Helper function to print the AST (for debugging)
-inline void print_ast(const AstNode* node, int indent = 0) {
-    if (!node) return;
-
-    for (int i = 0; i < indent; ++i) std::cout << "  ";
-
-    std::string type_str;
-    switch(node->type) {
-        case NodeType::NODE_UNKNOWN: type_str = "UNKNOWN"; break;
-        case NodeType::NODE_COMMAND: type_str = "COMMAND"; break;
-        case NodeType::NODE_SELECT_STATEMENT: type_str = "SELECT_STMT"; break;
-        case NodeType::NODE_INSERT_STATEMENT: type_str = "INSERT_STMT"; break;
-        case NodeType::NODE_DELETE_STATEMENT: type_str = "DELETE_STMT"; break;
-        case NodeType::NODE_IDENTIFIER: type_str = "IDENTIFIER"; break;
-        case NodeType::NODE_STRING_LITERAL: type_str = "STRING_LITERAL"; break;
-        case NodeType::NODE_NUMBER_LITERAL: type_str = "NUMBER_LITERAL"; break;
-        case NodeType::NODE_ASTERISK: type_str = "ASTERISK"; break;
-        case NodeType::NODE_SET_STATEMENT: type_str = "SET_STATEMENT"; break;
-        case NodeType::NODE_VARIABLE_ASSIGNMENT: type_str = "VAR_ASSIGN"; break;
-        case NodeType::NODE_USER_VARIABLE: type_str = "USER_VAR"; break;
-        case NodeType::NODE_SYSTEM_VARIABLE: type_str = "SYSTEM_VAR"; break;
-        case NodeType::NODE_VARIABLE_SCOPE: type_str = "VAR_SCOPE"; break;
-        case NodeType::NODE_EXPRESSION_PLACEHOLDER: type_str = "EXPR_PLACEHOLDER"; break;
-        case NodeType::NODE_SIMPLE_EXPRESSION: type_str = "SIMPLE_EXPRESSION"; break;
-        case NodeType::NODE_AGGREGATE_FUNCTION_CALL: type_str = "AGGREGATE_FUNC_CALL"; break;
-        case NodeType::NODE_SET_NAMES: type_str = "SET_NAMES"; break;
-        case NodeType::NODE_SET_CHARSET: type_str = "SET_CHARSET"; break;
-        case NodeType::NODE_DELETE_OPTIONS: type_str = "DELETE_OPTIONS"; break;
-        case NodeType::NODE_TABLE_NAME_LIST: type_str = "TABLE_NAME_LIST"; break;
-        case NodeType::NODE_FROM_CLAUSE: type_str = "FROM_CLAUSE"; break;
-        case NodeType::NODE_USING_CLAUSE: type_str = "USING_CLAUSE"; break;
-        case NodeType::NODE_WHERE_CLAUSE: type_str = "WHERE_CLAUSE"; break;
-        case NodeType::NODE_HAVING_CLAUSE: type_str = "HAVING_CLAUSE"; break;
-        case NodeType::NODE_ORDER_BY_CLAUSE: type_str = "ORDER_BY_CLAUSE"; break;
-        case NodeType::NODE_ORDER_BY_ITEM: type_str = "ORDER_BY_ITEM"; break;
-        case NodeType::NODE_LIMIT_CLAUSE: type_str = "LIMIT_CLAUSE"; break;
-        case NodeType::NODE_COMPARISON_EXPRESSION: type_str = "COMPARISON_EXPR"; break;
-        case NodeType::NODE_LOGICAL_AND_EXPRESSION: type_str = "LOGICAL_AND_EXPR"; break;
-        case NodeType::NODE_OPERATOR: type_str = "OPERATOR"; break;
-        case NodeType::NODE_QUALIFIED_IDENTIFIER: type_str = "QUALIFIED_IDENTIFIER"; break;
-        case NodeType::NODE_SELECT_OPTIONS: type_str = "SELECT_OPTIONS"; break;
-        case NodeType::NODE_SELECT_ITEM_LIST: type_str = "SELECT_ITEM_LIST"; break;
-        case NodeType::NODE_SELECT_ITEM: type_str = "SELECT_ITEM"; break;
-        case NodeType::NODE_ALIAS: type_str = "ALIAS"; break;
-        case NodeType::NODE_TABLE_REFERENCE: type_str = "TABLE_REFERENCE"; break;
-        case NodeType::NODE_GROUP_BY_CLAUSE: type_str = "GROUP_BY_CLAUSE"; break;
-        case NodeType::NODE_GROUPING_ELEMENT: type_str = "GROUPING_ELEMENT"; break;
-        case NodeType::NODE_JOIN_CLAUSE: type_str = "JOIN_CLAUSE"; break;
-        case NodeType::NODE_JOIN_TYPE_NATURAL_SPEC: type_str = "JOIN_TYPE_NATURAL_SPEC"; break;
-        case NodeType::NODE_JOIN_CONDITION_ON: type_str = "JOIN_CONDITION_ON"; break;
-        case NodeType::NODE_JOIN_CONDITION_USING: type_str = "JOIN_CONDITION_USING"; break;
-        case NodeType::NODE_COLUMN_LIST: type_str = "COLUMN_LIST"; break;
-        case NodeType::NODE_INTO_CLAUSE: type_str = "INTO_CLAUSE"; break;
-        case NodeType::NODE_INTO_VAR_LIST: type_str = "INTO_VAR_LIST"; break;
-        case NodeType::NODE_INTO_OUTFILE: type_str = "INTO_OUTFILE"; break;
-        case NodeType::NODE_INTO_DUMPFILE: type_str = "INTO_DUMPFILE"; break;
-        case NodeType::NODE_LOCKING_CLAUSE_LIST: type_str = "LOCKING_CLAUSE_LIST"; break;
-        case NodeType::NODE_LOCKING_CLAUSE: type_str = "LOCKING_CLAUSE"; break;
-        case NodeType::NODE_LOCK_STRENGTH: type_str = "LOCK_STRENGTH"; break;
-        case NodeType::NODE_LOCK_TABLE_LIST: type_str = "LOCK_TABLE_LIST"; break;
-        case NodeType::NODE_LOCK_OPTION: type_str = "LOCK_OPTION"; break;
-        case NodeType::NODE_DERIVED_TABLE: type_str = "DERIVED_TABLE"; break;
-        case NodeType::NODE_SUBQUERY: type_str = "SUBQUERY"; break;
-        case NodeType::NODE_FILE_OPTIONS: type_str = "FILE_OPTIONS"; break;
-        case NodeType::NODE_FIELDS_OPTIONS_CLAUSE: type_str = "FIELDS_OPTIONS_CLAUSE"; break;
-        case NodeType::NODE_LINES_OPTIONS_CLAUSE: type_str = "LINES_OPTIONS_CLAUSE"; break;
-        case NodeType::NODE_FIELDS_TERMINATED_BY: type_str = "FIELDS_TERMINATED_BY"; break;
-        case NodeType::NODE_FIELDS_ENCLOSED_BY: type_str = "FIELDS_ENCLOSED_BY"; break;
-        case NodeType::NODE_FIELDS_OPTIONALLY_ENCLOSED_BY: type_str = "FIELDS_OPTIONALLY_ENCLOSED_BY"; break;
-        case NodeType::NODE_FIELDS_ESCAPED_BY: type_str = "FIELDS_ESCAPED_BY"; break;
-        case NodeType::NODE_LINES_STARTING_BY: type_str = "LINES_STARTING_BY"; break;
-        case NodeType::NODE_LINES_TERMINATED_BY: type_str = "LINES_TERMINATED_BY"; break;
-        case NodeType::NODE_CHARSET_OPTION: type_str = "CHARSET_OPTION"; break;
-        case NodeType::NODE_KEYWORD: type_str = "KEYWORD"; break;
-        case NodeType::NODE_SHOW_STATEMENT: type_str = "SHOW_STMT"; break;
-        case NodeType::NODE_BEGIN_STATEMENT: type_str = "BEGIN_STMT"; break;
-        case NodeType::NODE_COMMIT_STATEMENT: type_str = "COMMIT_STMT"; break;
-        case NodeType::NODE_SHOW_OPTION_FULL: type_str = "SHOW_OPT_FULL"; break;
-        case NodeType::NODE_SHOW_OPTION_FIELDS: type_str = "SHOW_OPT_FIELDS"; break;
-        case NodeType::NODE_SHOW_TARGET_DATABASES: type_str = "SHOW_TARGET_DB"; break;
-        case NodeType::NODE_TABLE_SPECIFICATION: type_str = "TABLE_SPEC"; break;
-        case NodeType::NODE_IS_NULL_EXPRESSION: type_str = "IS_NULL_EXPR"; break;
-        case NodeType::NODE_IS_NOT_NULL_EXPRESSION: type_str = "IS_NOT_NULL_EXPR"; break;
-        default: type_str = "UNHANDLED_TYPE(" + std::to_string(static_cast<int>(node->type)) + ")"; break;
-    }
-    std::cout << "Type: " << type_str;
-    if (!node->value.empty()) {
-        std::cout << ", Value: '" << node->value << "'";
-    }
-    std::cout << std::endl;
-
-    for (const AstNode* child : node->children) {
-        print_ast(child, indent + 1);
-    }
-}
-
 } // namespace MysqlParser
 
 #endif // MYSQL_PARSER_AST_H
@@ -0,0 +1,22 @@
+#ifndef MYSQL_PARSER_AST_PRINT_H
+#define MYSQL_PARSER_AST_PRINT_H
+
+// Debugging and printing helpers for MysqlParser::AstNode trees.
+// Kept out of mysql_ast.h so that only the TUs that print pay for <iostream>.
+
+#include "mysql_ast.h"
+#include <iosfwd>
+
+namespace MysqlParser {
+
+// Short display name of a node type, e.g. "SELECT_STMT"; nullptr if unknown
+const char* node_type_name(NodeType type);
+
+// Prints the AST rooted at node, one node per line, indented by depth
+void print_ast(std::ostream& os, const AstNode* node, int indent = 0);
+// Same, to std::cout
+void print_ast(const AstNode* node, int indent = 0);
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_AST_PRINT_H
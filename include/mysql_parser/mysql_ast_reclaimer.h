@@ -0,0 +1,90 @@
+#ifndef MYSQL_PARSER_AST_RECLAIMER_H
+#define MYSQL_PARSER_AST_RECLAIMER_H
+
+#include "mysql_ast.h" // Uses MysqlParser::AstNode
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MysqlParser {
+
+struct AstReclaimerOptions {
+    // Trees each producing thread may have queued; once its queue is full,
+    // retire() frees the tree inline instead (see AstReclaimerStats::inline_frees).
+    // Rounded up to a power of two; 0 disables deferral.
+    size_t max_backlog_per_thread = 4096;
+    // Trees freed per queue before the consumer publishes progress and moves on
+    size_t batch_size = 64;
+    // Free on a dedicated thread; otherwise only reclaim() frees
+    bool background_thread = true;
+    // How often the background thread polls when it has not been woken
+    uint32_t poll_interval_us = 1000;
+};
+
+struct AstReclaimerStats {
+    uint64_t retired = 0;        // Trees handed to retire()
+    uint64_t reclaimed = 0;      // Trees freed off the calling thread
+    uint64_t inline_frees = 0;   // Trees freed inside retire() because the queue was full
+    uint64_t batches = 0;        // Non-empty batches freed
+    uint64_t reclaim_ns = 0;     // Time spent freeing in batches
+    size_t backlog = 0;          // Trees currently queued
+    size_t producer_threads = 0; // Threads with a queue (exited ones until it is drained)
+};
+
+// Takes finished ASTs off the latency-critical path: retire() appends the
+// tree to a wait-free single-producer queue owned by the calling thread, and
+// the trees are deleted later in batches, either by a background thread or
+// wherever the application calls reclaim() (e.g. when its event loop is idle).
+//
+// retire() may be called from any number of threads; reclaim() may be called
+// from any thread. The reclaimer must outlive all concurrent retire() calls.
+// Destruction stops the background thread and frees whatever is still queued.
+class AstReclaimer {
+public:
+    explicit AstReclaimer(const AstReclaimerOptions& options = AstReclaimerOptions());
+    ~AstReclaimer();
+
+    AstReclaimer(const AstReclaimer&) = delete;
+    AstReclaimer& operator=(const AstReclaimer&) = delete;
+
+    void retire(std::unique_ptr<AstNode> tree);
+
+    // Frees up to max_trees queued trees on the calling thread and returns how many
+    size_t reclaim(size_t max_trees = SIZE_MAX);
+
+    AstReclaimerStats getStats() const;
+    const AstReclaimerOptions& options() const { return options_; }
+
+    struct ProducerQueue; // One per (reclaimer, producing thread); see mysql_ast_reclaimer.cpp
+
+private:
+    ProducerQueue* queueForThisThread();
+    size_t drain(size_t max_trees);
+    void backgroundLoop();
+
+    AstReclaimerOptions options_;
+    const uint64_t id_; // Distinguishes reclaimers in the per-thread queue cache
+
+    mutable std::mutex mutex_; // Guards queues_ and serializes consumers
+    std::vector<std::shared_ptr<ProducerQueue>> queues_;
+    uint64_t exited_retired_ = 0;      // Counters of queues dropped after their thread exited
+    uint64_t exited_inline_frees_ = 0;
+    std::atomic<uint64_t> reclaimed_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> reclaim_ns_{0};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<bool> wake_requested_{false};
+    bool stopping_ = false; // Guarded by wake_mutex_
+    std::thread worker_;
+};
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_AST_RECLAIMER_H
@@ -0,0 +1,133 @@
+#ifndef MYSQL_PARSER_AST_SERIALIZE_H
+#define MYSQL_PARSER_AST_SERIALIZE_H
+
+// Compact, position-independent binary encoding of AstNode trees, for
+// sharing parsed statements between processes (files, shared memory).
+//
+// Layout, all multi-byte header fields little-endian:
+//
+//     header   "MAST", u16 version, u16 node type count,
+//              u32 node count, u32 nodes size, u32 string pool size
+//     nodes    one record per node in pre-order; each record is a run of
+//              varints: type, flags, value length, [value offset if length > 0],
+//              child count, size in bytes of the records of all descendants
+//     pool     the distinct value strings, concatenated without terminators
+//
+// Every reference is a byte offset into the blob itself, so a blob can be
+// read in place from any address: AstBlobView never copies or fixes up
+// anything. Blobs written with a different version or NodeType numbering
+// are rejected.
+
+#include "mysql_ast.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MysqlParser {
+
+constexpr uint16_t kAstFormatVersion = 1;
+constexpr size_t kAstBlobHeaderSize = 20;
+
+// Encodes trees into caller-provided buffers. Keeps its scratch space between
+// calls, so reuse one instance per thread.
+class AstSerializer {
+public:
+    // Lays out root (which must stay unchanged until write()) and returns the
+    // number of bytes the encoding takes; 0 for a null root or a tree whose
+    // nodes or strings exceed 4 GiB
+    size_t prepare(const AstNode* root);
+    // Writes the tree passed to the last prepare() into buffer. Returns the
+    // bytes written, or 0 if capacity is too small.
+    size_t write(void* buffer, size_t capacity) const;
+    // prepare() + write() into a new string
+    std::string serialize(const AstNode* root);
+
+private:
+    struct Entry {
+        const AstNode* node;
+        uint32_t parent;       // Index into entries_; unused for the root
+        uint32_t value_offset; // Into pool_
+        uint32_t child_count;  // Non-null children
+        uint64_t subtree_size; // Bytes of the records of all descendants
+    };
+    std::vector<Entry> entries_; // Pre-order
+    std::string pool_;
+    std::unordered_map<std::string_view, uint32_t> pool_index_;
+    std::vector<std::pair<const AstNode*, uint32_t>> stack_;
+    size_t nodes_size_ = 0;
+};
+
+class AstNodeView;
+
+// Read-only view of a serialized tree. The constructor validates the whole
+// blob once (bounds, structure, node types); after that, navigation does no
+// checking and no allocation. The viewed memory must outlive the view and
+// every AstNodeView taken from it.
+class AstBlobView {
+public:
+    AstBlobView(const void* data, size_t len);
+
+    bool valid() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+
+    size_t nodeCount() const { return node_count_; }
+    // Invalid view if !valid()
+    AstNodeView root() const;
+    // Bytes the blob occupies, which may be less than the len it was given
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* nodes_ = nullptr;
+    const uint8_t* nodes_end_ = nullptr;
+    const char* pool_ = nullptr;
+    size_t node_count_ = 0;
+    size_t size_ = 0;
+    std::string error_;
+};
+
+// One node of an AstBlobView. Cheap to copy; default-constructed and
+// past-the-end views test false.
+class AstNodeView {
+public:
+    AstNodeView() = default;
+
+    explicit operator bool() const { return record_ != nullptr; }
+    NodeType type() const { return type_; }
+    std::string_view value() const { return std::string_view(value_, value_len_); }
+    bool escaped() const { return escaped_; }
+    size_t childCount() const { return child_count_; }
+
+    AstNodeView firstChild() const;
+    AstNodeView nextSibling() const;
+    // O(i): skips the subtrees of the preceding siblings
+    AstNodeView child(size_t i) const;
+
+    // Copies the subtree into a heap-allocated AstNode tree
+    std::unique_ptr<AstNode> materialize() const;
+
+private:
+    friend class AstBlobView;
+    AstNodeView(const uint8_t* record, const uint8_t* siblings_end, const char* pool);
+
+    const uint8_t* record_ = nullptr;
+    const uint8_t* children_ = nullptr;     // First child's record
+    const uint8_t* subtree_end_ = nullptr;  // Next sibling's record
+    const uint8_t* siblings_end_ = nullptr; // End of the parent's descendants
+    const char* pool_ = nullptr;
+    const char* value_ = nullptr;
+    uint32_t value_len_ = 0;
+    uint32_t child_count_ = 0;
+    NodeType type_ = NodeType::NODE_UNKNOWN;
+    bool escaped_ = false;
+};
+
+// Validates and materializes a blob; nullptr (and *error set) if it is invalid
+std::unique_ptr<AstNode> deserialize_ast(const void* data, size_t len, std::string* error = nullptr);
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_AST_SERIALIZE_H
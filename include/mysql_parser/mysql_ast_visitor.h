@@ -0,0 +1,114 @@
+#ifndef MYSQL_PARSER_AST_VISITOR_H
+#define MYSQL_PARSER_AST_VISITOR_H
+
+#include "mysql_ast.h"
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MysqlParser {
+
+// Compile-time tag for a node type, used to select AstVisitor handlers by overload
+template <NodeType T>
+struct NodeTag {
+    static constexpr NodeType type = T;
+};
+
+enum class VisitAction {
+    Continue,     // Visit the children of this node
+    SkipChildren, // Do not descend into this node
+    Stop          // End the walk
+};
+
+// CRTP visitor over an AstNode tree.
+//
+// Derived declares handlers only for the node types it cares about:
+//
+//     struct TableCollector : AstVisitor<TableCollector> {
+//         VisitAction visit(NodeTag<NodeType::NODE_TABLE_REFERENCE>, const AstNode& node);
+//         VisitAction visit(NodeTag<NodeType::NODE_FUNCTION_CALL>, const AstNode& node);
+//     };
+//
+// Every other type goes to visit_default(), which Derived may also override.
+// Handler selection happens at compile time: a constexpr table indexed by
+// NodeType holds one thunk per type, so dispatching a node is a single
+// indexed indirect call. The walk is pre-order and uses an explicit stack,
+// so deep trees do not consume native stack.
+//
+// Use Node = AstNode for visitors that modify nodes in place.
+template <typename Derived, typename Node = const AstNode>
+class AstVisitor {
+public:
+    // Walks the tree rooted at root; returns false if a handler returned Stop
+    bool walk(Node* root) {
+        if (!root) return true;
+        stack_.clear();
+        stack_.push_back(root);
+        while (!stack_.empty()) {
+            Node* node = stack_.back();
+            stack_.pop_back();
+            VisitAction action = dispatch(*node);
+            if (action == VisitAction::Stop) return false;
+            if (action == VisitAction::SkipChildren) continue;
+            // Push in reverse so children are visited left to right
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) stack_.push_back(*it);
+            }
+        }
+        return true;
+    }
+
+    // Calls the handler for node's type without descending
+    VisitAction dispatch(Node& node) {
+        size_t idx = static_cast<size_t>(node.type);
+        if (idx >= kNodeTypeCount) return derived().visit_default(node);
+        return kTable[idx](derived(), node);
+    }
+
+    // Fallback for node types without a dedicated handler
+    VisitAction visit_default(Node&) { return VisitAction::Continue; }
+
+private:
+    using Thunk = VisitAction (*)(Derived&, Node&);
+
+    template <NodeType T, typename = void>
+    struct HasHandler : std::false_type {};
+    template <NodeType T>
+    struct HasHandler<T, std::void_t<decltype(std::declval<Derived&>().visit(NodeTag<T>{}, std::declval<Node&>()))>>
+        : std::true_type {};
+
+    template <NodeType T>
+    static VisitAction thunk(Derived& self, Node& node) {
+        if constexpr (HasHandler<T>::value) {
+            return self.visit(NodeTag<T>{}, node);
+        } else {
+            return self.visit_default(node);
+        }
+    }
+
+    template <size_t... I>
+    static constexpr std::array<Thunk, sizeof...(I)> make_table(std::index_sequence<I...>) {
+        return {{ &thunk<static_cast<NodeType>(I)>... }};
+    }
+
+    static constexpr std::array<Thunk, kNodeTypeCount> kTable = make_table(std::make_index_sequence<kNodeTypeCount>{});
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    std::vector<Node*> stack_; // Reused across walks
+};
+
+// Returns the first direct child of node with the given type, or nullptr
+template <typename Node>
+inline Node* find_child(Node* node, NodeType type) {
+    if (!node) return nullptr;
+    for (auto* child : node->children) {
+        if (child && child->type == type) return child;
+    }
+    return nullptr;
+}
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_AST_VISITOR_H
@@ -0,0 +1,71 @@
+#ifndef MYSQL_PARSER_BULK_PARSER_H
+#define MYSQL_PARSER_BULK_PARSER_H
+
+#include "mysql_ast.h" // Uses MysqlParser::AstNode
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+namespace MysqlParser {
+
+// Byte range of one statement inside a bulk input buffer
+struct StatementSpan {
+    size_t offset;
+    size_t length;
+};
+
+// One parsed statement, handed to the callback in input order. The result is
+// only valid during the callback: sql points into the input (for parseFile, a
+// mapping that is unmapped when parsing ends) and ast is freed once the
+// callback returns. Copy sql, or move ast out, to keep either.
+struct BulkParseResult {
+    size_t index;                    // Ordinal of the statement in the input
+    std::string_view sql;            // Points into the caller's buffer or the file mapping
+    std::unique_ptr<AstNode> ast;    // nullptr if parsing failed
+    std::vector<std::string> errors; // Parser errors for this statement
+};
+
+using BulkParseCallback = std::function<void(BulkParseResult& result)>;
+
+// Parses large SQL dumps / query logs on a pool of Parser instances.
+// Statements are split with a quote- and comment-aware pre-scan, parsed in
+// parallel straight out of the input buffer, and delivered to the callback
+// in their original order on the calling thread.
+class BulkParser {
+public:
+    // num_threads == 0 uses std::thread::hardware_concurrency()
+    explicit BulkParser(unsigned num_threads = 0);
+
+    // Memory-maps the file at path and parses every statement in it.
+    // Returns false (see getErrors()) if the file cannot be opened or mapped.
+    bool parseFile(const std::string& path, const BulkParseCallback& callback);
+
+    // Parses every statement in [data, data + len). The buffer must stay
+    // valid until the call returns; it is never copied.
+    void parseBuffer(const char* data, size_t len, const BulkParseCallback& callback);
+
+    // Splits [data, data + len) at ';' terminators that are not inside a
+    // quoted string, backticked identifier or comment. Pieces holding only
+    // whitespace and comments are dropped, except that /*! ... */ versioned
+    // comments count as code; each span keeps its terminating ';'.
+    // Like the mysql client, a "DELIMITER <tok>" line at the start of a
+    // statement switches the terminator to <tok> (as in mysqldump's
+    // "DELIMITER ;;" around trigger and routine bodies) until the next
+    // DELIMITER line. Those lines are not returned, and spans end before a
+    // custom terminator, which is not part of the statement.
+    static std::vector<StatementSpan> splitStatements(const char* data, size_t len);
+
+    unsigned threadCount() const { return num_threads_; }
+    const std::vector<std::string>& getErrors() const { return errors_; }
+
+private:
+    unsigned num_threads_;
+    std::vector<std::string> errors_;
+};
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_BULK_PARSER_H
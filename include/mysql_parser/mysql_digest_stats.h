@@ -0,0 +1,94 @@
+#ifndef MYSQL_PARSER_DIGEST_STATS_H
+#define MYSQL_PARSER_DIGEST_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MysqlParser {
+
+struct DigestStatsOptions {
+    // Distinct digests kept between resets; statements with a new digest are
+    // counted in DigestStatsSnapshot::dropped once this many are tracked.
+    size_t max_digests = 4096;
+    // Counter shards; threads are spread over them round-robin. Rounded up to
+    // a power of two; 0 means one per hardware thread.
+    size_t shards = 0;
+    // Bytes of the first query text seen for a digest kept as its sample; 0 keeps none
+    size_t max_sample_bytes = 1024;
+};
+
+// Aggregated counters of one digest
+struct DigestStats {
+    uint64_t digest = 0;
+    std::string sample; // Query text recorded with the first call, if any
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t rows = 0;
+    uint64_t total_ns = 0;
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+
+    double meanNs() const { return calls ? static_cast<double>(total_ns) / calls : 0.0; }
+};
+
+struct DigestStatsSnapshot {
+    std::vector<DigestStats> digests; // In table order; sort as needed
+    uint64_t dropped = 0;             // Calls not counted because the table was full
+};
+
+// pg_stat_statements-style execution statistics per statement digest
+// (Parser::getDigest()). record() is lock-free: a probe of a fixed-size
+// open-addressing table, whose slots are claimed with one compare-and-swap,
+// then a few relaxed atomic adds on the calling thread's counter shard.
+//
+// The table is double-buffered. snapshotAndReset() switches recorders to the
+// other buffer, waits for calls still writing to the old one, and returns
+// its totals exactly, so no call is lost or counted twice between two
+// collections. snapshot() reads the live buffer instead and may see a call
+// that is only partly counted.
+//
+// record() may be called from any number of threads. Collecting calls are
+// serialized with each other, never with record().
+class DigestStatsAggregator {
+public:
+    explicit DigestStatsAggregator(const DigestStatsOptions& options = DigestStatsOptions());
+    ~DigestStatsAggregator();
+
+    DigestStatsAggregator(const DigestStatsAggregator&) = delete;
+    DigestStatsAggregator& operator=(const DigestStatsAggregator&) = delete;
+
+    // Counts one execution of a statement with this digest. sample is stored
+    // only by the call that adds the digest to the table. Digest 0 (no
+    // statement) is ignored.
+    void record(uint64_t digest, uint64_t latency_ns, uint64_t rows = 0, bool error = false,
+                std::string_view sample = std::string_view());
+
+    DigestStatsSnapshot snapshot() const;
+    DigestStatsSnapshot snapshotAndReset();
+    void reset();
+
+    const DigestStatsOptions& options() const { return options_; }
+
+    struct Table; // One buffer: keys, samples and per-shard counters; see mysql_digest_stats.cpp
+
+private:
+    DigestStatsSnapshot collect(const Table& table) const;
+    // Makes the other table current and waits until nothing writes to the old one
+    Table& switchTables();
+
+    DigestStatsOptions options_;
+    size_t shard_mask_;
+    std::unique_ptr<Table> tables_[2];
+    std::atomic<unsigned> active_{0}; // Index into tables_ that record() writes to
+    mutable std::mutex collect_mutex_;
+};
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_DIGEST_STATS_H
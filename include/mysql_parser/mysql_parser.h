@@ -5,37 +5,107 @@
 #include <string>
 #include <vector>
 #include <memory>
-
-typedef void* yyscan_t; // Should be the same opaque type for Flex
+#include <cstdint>
 
 namespace MysqlParser { // Changed namespace
 
+// Per-call budgets for Parser::parse(); 0 means unlimited. A parse that
+// exceeds one stops at once and returns nullptr, with getStatus() telling
+// which budget ran out.
+struct ParseLimits {
+    size_t max_bytes = 0;   // Length of the query text
+    size_t max_tokens = 0;
+    size_t max_nodes = 0;   // AST nodes allocated
+    size_t max_depth = 0;   // Parenthesis nesting
+    uint64_t max_time_us = 0;           // Wall-clock budget from the start of parse()
+    size_t time_check_interval = 256;   // Tokens between clock reads when max_time_us is set
+};
+
+enum class ParseStatus {
+    Ok,                // Parsed, or empty input
+    SyntaxError,       // See getErrors()
+    ScannerError,      // The scanner could not be set up
+    BytesExceeded,
+    TokensExceeded,
+    NodesExceeded,
+    DepthExceeded,
+    DeadlineExceeded
+};
+
+class ParserContext; // Scanner and Bison state, see src/mysql_parser/mysql_parser_internal.h
+class SessionState;  // See mysql_session_state.h
+class SymbolTable;   // See mysql_symbol_table.h
+struct Statement;    // See mysql_statement.h
+struct QueryComments; // See mysql_query_comments.h
+class TokenBuffer;    // See mysql_token_buffer.h
+
 class Parser {
 public:
+    // Cheap: the Flex scanner is taken from a shared pool on the first parse()
     Parser();
     ~Parser();
 
+    Parser(Parser&& other) noexcept;
+    Parser& operator=(Parser&& other) noexcept;
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+
     std::unique_ptr<AstNode> parse(const std::string& sql_query);
+    // Parses sql_len bytes at sql_query; the range need not be NUL-terminated
+    std::unique_ptr<AstNode> parse(const char* sql_query, size_t sql_len);
+    // Same, aborting as soon as any of limits is exceeded
+    std::unique_ptr<AstNode> parse(const std::string& sql_query, const ParseLimits& limits);
+    std::unique_ptr<AstNode> parse(const char* sql_query, size_t sql_len, const ParseLimits& limits);
+    // Parses a query already lexed into tokens, without scanning its text
+    // again; the results are those of parsing tokens.query(), and the comment
+    // offsets refer to it
+    std::unique_ptr<AstNode> parse(const TokenBuffer& tokens);
+    std::unique_ptr<AstNode> parse(const TokenBuffer& tokens, const ParseLimits& limits);
 
-    const std::vector<std::string>& getErrors() const;
-    void clearErrors();
+    // Outcome of the last parse()
+    ParseStatus getStatus() const;
 
-    // Internal methods for Bison/Flex interaction
-    void internal_set_ast(AstNode* root);
-    void internal_add_error(const std::string& msg);
-    void internal_add_error_at(const std::string& msg, int line, int column);
+    // Typed clauses of the statement returned by the last parse(), recorded
+    // as the tree was built. The pointers are into that tree:
+    // valid while the caller keeps it and until the next parse(). Kind None
+    // after a failed parse.
+    const Statement& getStatement() const;
 
+    // Comments, optimizer hints and key=value annotations seen by the last
+    // parse(), as offsets into the text it was given; also set after a failed parse
+    const QueryComments& getComments() const;
+
+    // 64-bit digest of the statement shape read by the last parse(): keywords
+    // and punctuation, identifiers by name, and every literal as a
+    // placeholder, with a comma-separated run of literals counted as one
+    // (so "VALUES (1, 'a')" and "VALUES (2, 'b', 3)" agree). Comments,
+    // whitespace and semicolons do not count. Stable across processes and
+    // builds of the same grammar; 0 only if no token was read. After a syntax
+    // error it covers the tokens up to the error. See mysql_digest_stats.h.
+    uint64_t getDigest() const;
+
+    // Successfully parsed SET statements update state (not owned; nullptr to detach)
+    void setSessionState(SessionState* state);
+
+    // Interns identifier, variable, alias and function names into symbols
+    // (AstNode::symbol) while parsing. Not owned; the table may be shared by
+    // any number of parsers and must outlive every use of the symbols.
+    // nullptr to detach.
+    void setSymbolTable(SymbolTable* symbols);
+
+    // Simple SELECT, INSERT, SET, BEGIN and COMMIT statements are first tried
+    // by a hand-written recognizer that bypasses the scanner and grammar; its
+    // results are identical, so this only matters for measuring or checking
+    // it. On by default.
+    void setFastPath(bool enabled);
+
+    const std::vector<std::string>& getErrors() const;
+    void clearErrors();
 
 private:
-    std::unique_ptr<AstNode> ast_root_;
-    std::vector<std::string> errors_;
-    yyscan_t scanner_state_;
+    std::unique_ptr<ParserContext> context_;
 };
 
 } // namespace MysqlParser
 
-// Declaration for mysql_yyerror, which is called by Bison's mysql_yyparse.
-// As both generated parser and this definition will be C++, extern "C" not strictly needed here.
-void mysql_yyerror(yyscan_t yyscanner, MysqlParser::Parser* parser_context, const char* msg); // Changed prefix
-
 #endif // MYSQL_PARSER_PARSER_H
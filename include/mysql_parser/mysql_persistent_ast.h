@@ -0,0 +1,79 @@
+#ifndef MYSQL_PARSER_PERSISTENT_AST_H
+#define MYSQL_PARSER_PERSISTENT_AST_H
+
+// Immutable, reference-counted AST with structural sharing, for deriving
+// rewritten statements from a tree that must be kept, such as a cached
+// template. An edit copies only the nodes on the path from the root to the
+// edited node; every other subtree is shared between the old and new trees.
+//
+// Nodes never change once built, so trees may be read, shared and edited
+// from any number of threads; reference counts are atomic. Convert from a
+// parsed tree with make_persistent(), and back with materialize_ast() for the
+// AstNode consumers (AstVisitor, printing, serialization).
+
+#include "mysql_ast.h" // Uses MysqlParser::AstNode, NodeType
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MysqlParser {
+
+struct PersistentNode;
+using PersistentNodePtr = std::shared_ptr<const PersistentNode>;
+
+// Same fields as AstNode. Build new nodes with std::make_shared; once a node
+// is held as a PersistentNodePtr it must not be modified.
+struct PersistentNode {
+    NodeType type;
+    std::string value;
+    std::vector<PersistentNodePtr> children; // Never null
+    bool escaped = false;
+    uint32_t symbol = 0;
+
+    PersistentNode(NodeType t, std::string val = std::string()) : type(t), value(std::move(val)) {}
+    // Iterative, like ~AstNode(): releasing the last reference to a deep tree
+    // uses constant stack
+    ~PersistentNode();
+
+    PersistentNode(const PersistentNode&) = delete;
+    PersistentNode& operator=(const PersistentNode&) = delete;
+};
+
+// Child index at each level on the way down from a root; empty for the root
+using AstPath = std::vector<uint32_t>;
+
+// Deep copy of a parsed tree (nullptr for nullptr)
+PersistentNodePtr make_persistent(const AstNode* root);
+// Deep copy back into a heap-allocated AstNode tree
+std::unique_ptr<AstNode> materialize_ast(const PersistentNode* root);
+
+// Single-node edits: a new node with the same fields and children as node
+// except for the change. The children are shared, not copied. nullptr if i
+// is out of range or child is null.
+PersistentNodePtr with_value(const PersistentNode& node, std::string value);
+PersistentNodePtr with_child(const PersistentNode& node, size_t i, PersistentNodePtr child);
+PersistentNodePtr with_inserted_child(const PersistentNode& node, size_t i, PersistentNodePtr child); // i <= size
+PersistentNodePtr without_child(const PersistentNode& node, size_t i);
+
+// New root of the tree in which the node at path is replacement. Only the
+// ancestors of that node are copied, so the cost is the length of the path
+// plus their child counts; root itself is unchanged. nullptr if path leaves
+// the tree or replacement is null.
+PersistentNodePtr replace_at(const PersistentNodePtr& root, const AstPath& path, PersistentNodePtr replacement);
+
+// Node at path, or nullptr if path leaves the tree
+const PersistentNode* node_at(const PersistentNode* root, const AstPath& path);
+// Path to the first node in pre-order that match accepts, or of type; false
+// if there is none
+bool find_path(const PersistentNode* root, const std::function<bool(const PersistentNode&)>& match, AstPath* path);
+bool find_path(const PersistentNode* root, NodeType type, AstPath* path);
+
+// Structural equality, O(1) for subtrees the two trees share
+bool same_tree(const PersistentNode* a, const PersistentNode* b);
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_PERSISTENT_AST_H
@@ -0,0 +1,98 @@
+#ifndef MYSQL_PARSER_QUERY_COMMENTS_H
+#define MYSQL_PARSER_QUERY_COMMENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace MysqlParser {
+
+// Vector of trivially copyable T that keeps its first N elements inline and
+// only allocates once it grows past N.
+template <typename T, size_t N>
+class InlineVector {
+public:
+    void push_back(const T& v) {
+        if (heap_.empty()) {
+            if (size_ < N) {
+                inline_[size_++] = v;
+                return;
+            }
+            heap_.assign(inline_, inline_ + size_);
+        }
+        heap_.push_back(v);
+        ++size_;
+    }
+    void clear() {
+        size_ = 0;
+        heap_.clear(); // Keeps its capacity for the next overflow
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T* data() const { return heap_.empty() ? inline_ : heap_.data(); }
+    const T& operator[](size_t i) const { return data()[i]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+
+private:
+    T inline_[N];
+    size_t size_ = 0;
+    std::vector<T> heap_;
+};
+
+enum class CommentKind : uint8_t {
+    Block,     // /* ... */
+    Hint,      // /*+ ... */ optimizer hint
+    Versioned, // /*! ... */ executable comment (not executed by this parser)
+    Line       // # ... and -- ...
+};
+
+// Byte range of a comment's body in the parsed query text, without the
+// delimiters ("/*+", "*/", "# ", ...)
+struct CommentSpan {
+    uint32_t offset;
+    uint32_t length;
+    CommentKind kind;
+
+    std::string_view text(std::string_view sql) const { return sql.substr(offset, length); }
+};
+
+// A key=value pair found in a block or line comment, e.g. /* hostgroup=2 */.
+// Quoted values are stored without their quotes.
+struct CommentAnnotation {
+    uint32_t key_offset;
+    uint32_t key_length;
+    uint32_t value_offset;
+    uint32_t value_length;
+
+    std::string_view key(std::string_view sql) const { return sql.substr(key_offset, key_length); }
+    std::string_view value(std::string_view sql) const { return sql.substr(value_offset, value_length); }
+};
+
+// Comments the lexer saw while parsing a statement, recorded in the same
+// scan as the tokens. Only offsets are stored: pass the query text that was
+// parsed to the accessors. Nothing is allocated unless a statement has more
+// than four comments or annotations.
+struct QueryComments {
+    InlineVector<CommentSpan, 4> comments;
+    InlineVector<CommentAnnotation, 4> annotations;
+
+    bool empty() const { return comments.empty(); }
+    void clear() {
+        comments.clear();
+        annotations.clear();
+    }
+    bool hasHints() const;
+    // Last annotation with this key (ASCII case-insensitive); nullptr if none
+    const CommentAnnotation* findAnnotation(std::string_view sql, std::string_view key) const;
+};
+
+// Splits a comment body at whitespace, ',' and ';' and appends every
+// key=value pair to out. body_offset is the offset of body in the query text.
+void parse_comment_annotations(const char* body, size_t length, size_t body_offset, QueryComments& out);
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_QUERY_COMMENTS_H
@@ -0,0 +1,117 @@
+#ifndef MYSQL_PARSER_QUERY_RULES_H
+#define MYSQL_PARSER_QUERY_RULES_H
+
+#include "mysql_ast.h" // Uses MysqlParser::AstNode, NodeType
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MysqlParser {
+
+// What a query looks like to the rules engine, extracted from its AST once
+// and then matched against any number of rules.
+struct QueryFeatures {
+    NodeType statement = NodeType::NODE_UNKNOWN; // Type of the root node
+    std::vector<std::string> tables;           // Lower-cased; "db.t" also contributes "t"
+    std::vector<std::string> system_variables; // Lower-cased NODE_SYSTEM_VARIABLE names
+    bool for_update = false; // Top-level FOR UPDATE
+    bool for_share = false;  // Top-level FOR SHARE
+    bool has_limit = false;  // Top-level LIMIT
+
+    void clear();
+};
+
+// Fills features from the AST rooted at root (features is cleared first)
+void extract_query_features(const AstNode* root, QueryFeatures& features);
+
+enum class LockMatch {
+    Any,       // Do not care
+    None,      // No locking clause
+    ForUpdate, // FOR UPDATE
+    ForShare,  // FOR SHARE
+    Locking    // FOR UPDATE or FOR SHARE
+};
+
+enum class LimitMatch {
+    Any,
+    Present,
+    Absent
+};
+
+// A routing/rewrite rule written as a pattern over QueryFeatures. Every
+// condition that is set must hold; empty lists and Any are wildcards.
+struct QueryRule {
+    int id = 0;                                      // Caller-defined, e.g. a destination or rewrite id
+    NodeType statement = NodeType::NODE_UNKNOWN;     // NODE_UNKNOWN matches every statement type
+    std::vector<std::string> tables;                 // Query references at least one of these ("t" or "db.t")
+    std::vector<std::string> system_variables;       // Query references at least one of these
+    LockMatch lock = LockMatch::Any;
+    LimitMatch limit = LimitMatch::Any;
+
+    // Evaluates this rule alone, without an index
+    bool matches(const QueryFeatures& features) const;
+};
+
+// Indices of the rules that matched, in rule order (lowest index first)
+class RuleMatchSet {
+public:
+    bool empty() const;
+    // Index of the first (highest-priority) matching rule, or -1
+    long first() const;
+    std::vector<size_t> indices() const;
+
+private:
+    friend class QueryRuleSet;
+    std::vector<uint64_t> bits_;
+    std::vector<uint64_t> scratch_; // Per-feature mask being built during match()
+};
+
+// A set of QueryRules compiled into per-feature bitset indexes. Matching a
+// query intersects one mask per feature and ORs the posting lists of the
+// tables and variables it references, so its cost grows with the number of
+// features in the query, not the number of rules (beyond one word per 64
+// rules for the bitset arithmetic).
+//
+// Rules are ordered by insertion; the first matching rule has priority.
+// Call compile() after the last addRule(). match() is const and may be
+// called from several threads at once on a compiled set.
+class QueryRuleSet {
+public:
+    // Returns the index of the new rule. Invalidates the compiled index.
+    size_t addRule(QueryRule rule);
+    void compile();
+    bool isCompiled() const { return compiled_; }
+
+    size_t size() const { return rules_.size(); }
+    const QueryRule& rule(size_t index) const { return rules_[index]; }
+
+    // out is reused across calls to avoid reallocating its bitset.
+    // An uncompiled set matches nothing.
+    void match(const QueryFeatures& features, RuleMatchSet& out) const;
+    // Convenience: first matching rule, or nullptr
+    const QueryRule* matchFirst(const QueryFeatures& features) const;
+
+private:
+    using Bitset = std::vector<uint64_t>;
+    using Postings = std::unordered_map<std::string, std::vector<uint32_t>>;
+
+    static void or_postings(const Postings& postings, const std::vector<std::string>& keys, Bitset& out);
+
+    std::vector<QueryRule> rules_;
+    bool compiled_ = false;
+    size_t words_ = 0;
+
+    std::array<Bitset, kNodeTypeCount> statement_masks_; // Rules accepting each root type
+    std::array<Bitset, 4> lock_masks_;   // Indexed by for_update | for_share << 1
+    std::array<Bitset, 2> limit_masks_;  // Indexed by has_limit
+    Bitset any_table_mask_;              // Rules without a table condition
+    Bitset any_variable_mask_;           // Rules without a variable condition
+    Postings table_postings_;            // Table name -> rules naming it
+    Postings variable_postings_;         // Variable name -> rules naming it
+};
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_QUERY_RULES_H
@@ -0,0 +1,88 @@
+#ifndef MYSQL_PARSER_SESSION_STATE_H
+#define MYSQL_PARSER_SESSION_STATE_H
+
+#include "mysql_ast.h" // Uses MysqlParser::AstNode
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MysqlParser {
+
+// Process-wide id of a variable name. Names are lower-cased before interning,
+// so "AUTOCOMMIT" and "autocommit" share an id. Thread-safe.
+using VariableId = uint32_t;
+VariableId intern_variable_name(const std::string& name);
+// Name an id was interned from (lower-cased)
+std::string variable_name(VariableId id);
+
+// Which part of the session an assignment affects. GLOBAL/PERSIST assignments
+// change server state, not session state, and are not tracked.
+enum class VariableScope : uint8_t {
+    Session,         // SET [SESSION] var = ..., SET @@var = ..., SET NAMES, ...
+    User,            // SET @var = ...
+    NextTransaction  // SET TRANSACTION ... without a scope
+};
+
+struct SessionVariable {
+    VariableScope scope;
+    VariableId id;
+    std::string value;   // Canonical text of the assigned expression, see format_session_value()
+    uint64_t value_hash; // Hash of value
+};
+
+// What differs between two states, see SessionState::diff()
+struct SessionStateDiff {
+    std::vector<SessionVariable> changed; // Set in the target, with a different or no value in the source
+    std::vector<SessionVariable> removed; // Set in the source only; the target has the server default
+    bool empty() const { return changed.empty() && removed.empty(); }
+};
+
+// The session variables a client has changed, kept sorted by (scope, id)
+// together with an order-independent hash that is updated incrementally.
+// Two sessions can share a backend connection as-is when their hashes (and,
+// to rule out collisions, their states) are equal; otherwise diff() lists
+// exactly the assignments to replay.
+//
+// Attach a state to a Parser with Parser::setSessionState(): the SET, SET
+// NAMES, SET CHARACTER SET and SET TRANSACTION grammar rules then record
+// their assignments directly while parsing, and they are applied once the
+// statement has parsed successfully. SET x = DEFAULT erases x, so a session
+// that reset a variable hashes equal to one that never changed it.
+class SessionState {
+public:
+    void set(VariableScope scope, VariableId id, std::string value);
+    void set(VariableScope scope, const std::string& name, std::string value);
+    // Returns false if the variable was not set
+    bool erase(VariableScope scope, VariableId id);
+    void clear();
+    // Drops NextTransaction entries; call when the transaction they applied to ends
+    void endTransaction();
+
+    // nullptr if not set
+    const SessionVariable* find(VariableScope scope, VariableId id) const;
+    const std::vector<SessionVariable>& variables() const { return variables_; }
+    size_t size() const { return variables_.size(); }
+    bool empty() const { return variables_.empty(); }
+
+    // O(1); equal states always have equal hashes
+    uint64_t hash() const { return hash_; }
+
+    // Assignments that turn *this into target, in (scope, id) order
+    SessionStateDiff diff(const SessionState& target) const;
+
+    bool operator==(const SessionState& other) const;
+    bool operator!=(const SessionState& other) const { return !(*this == other); }
+
+private:
+    std::vector<SessionVariable> variables_;
+    uint64_t hash_ = 0;
+};
+
+// Canonical text for an assigned expression: literal values as written
+// (string literals unquoted), identifiers and keywords upper-cased, anything
+// else as TYPE(value,children...).
+std::string format_session_value(const AstNode* value);
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_SESSION_STATE_H
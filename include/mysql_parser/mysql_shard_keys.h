@@ -0,0 +1,107 @@
+#ifndef MYSQL_PARSER_SHARD_KEYS_H
+#define MYSQL_PARSER_SHARD_KEYS_H
+
+#include "mysql_ast.h"       // Uses MysqlParser::AstNode, NodeType
+#include "mysql_statement.h" // Uses MysqlParser::Statement
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MysqlParser {
+
+// The column a table is sharded on
+struct ShardKey {
+    std::string table;  // "t" or "db.t"; "t" also matches "db.t" in queries
+    std::string column;
+};
+
+// A constant from the statement: a number or string literal of the parsed
+// tree, valid as long as the tree is
+struct ShardValue {
+    const AstNode* literal = nullptr; // NODE_NUMBER_LITERAL or NODE_STRING_LITERAL
+    bool negative = false;            // Number under unary minus: -literal
+
+    bool isString() const { return literal->type == NodeType::NODE_STRING_LITERAL; }
+    // Digits of a number (without the sign) or the unescaped string
+    std::string_view text() const { return literal->value; }
+};
+
+struct ShardBound {
+    ShardValue value;       // value.literal is nullptr when unbounded
+    bool inclusive = false; // <= or >= rather than < or >
+};
+
+// What the statement says about the shard key of one table it reads or
+// writes. A table referenced twice (a self-join) gets one constraint per
+// reference.
+struct ShardConstraint {
+    uint16_t key = 0;               // Index of the ShardKey in its ShardKeySet
+    const AstNode* table = nullptr; // The table's name in the statement
+    std::string_view qualifier;     // Alias, or the table name, that qualifies its columns
+    bool has_values = false;        // The key is one of the values: = or IN, or the rows of an INSERT
+    uint16_t first_value = 0;       // Into ShardRouting::values
+    uint16_t value_count = 0;
+    ShardBound lower, upper;        // From <, <=, > and >=, also kept alongside values
+};
+
+// Result of ShardKeySet::extract(), in fixed-size storage so that routing
+// allocates nothing: keep one per thread and pass it to every call.
+struct ShardRouting {
+    static constexpr size_t kMaxConstraints = 16;
+    static constexpr size_t kMaxValues = 64;
+
+    // Some sharded table's key is not bound to a list of values, so the
+    // statement may touch any shard (ranges are still reported, for range
+    // sharding). False with no constraints: the statement reads no sharded
+    // table.
+    bool spans_all_shards = false;
+    bool truncated = false; // Ran out of constraints or values; spans_all_shards is set
+    size_t constraint_count = 0;
+    size_t value_count = 0;
+    std::array<ShardConstraint, kMaxConstraints> constraints;
+    std::array<ShardValue, kMaxValues> values;
+
+    void clear();
+    const ShardValue* valuesOf(const ShardConstraint& c) const { return values.data() + c.first_value; }
+};
+
+// A configured set of shard keys, matched against statements to find the
+// constants their keys are bound to:
+//
+//   WHERE user_id = 42                     values {42}
+//   WHERE u.user_id IN (1, 2) AND ...      values {1, 2}: conjuncts of an AND chain
+//   WHERE user_id >= 100 AND user_id < 200 range [100, 200)
+//   INSERT INTO t (user_id, ...) VALUES    values of the key column in each row
+//
+// Only what the statement proves is reported, so every row it touches is
+// within the constraints (they may be wider than necessary): conditions on
+// other columns, non-constant operands, !=, NOT IN and JOIN ... ON
+// conditions are ignored, and a key bound twice keeps the narrower binding.
+// Derived tables are matched against their own WHERE clauses.
+//
+// Table and column names compare ASCII case-insensitively. Keys are looked
+// up by scanning the set, which suits the handful of sharded tables of a
+// deployment. extract() is const and may be called from several threads at
+// once.
+class ShardKeySet {
+public:
+    // Returns the index of the new key. Names are stored lower-cased.
+    size_t addKey(std::string table, std::string column);
+    size_t size() const { return keys_.size(); }
+    const ShardKey& key(size_t index) const { return keys_[index]; }
+
+    // Straight after a parse, from Parser::getStatement(); out is cleared first
+    void extract(const Statement& statement, ShardRouting& out) const;
+    // From any statement tree (see statement_of())
+    void extract(const AstNode* root, ShardRouting& out) const;
+
+private:
+    std::vector<ShardKey> keys_; // Lower-cased
+};
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_SHARD_KEYS_H
@@ -0,0 +1,85 @@
+#ifndef MYSQL_PARSER_STATEMENT_H
+#define MYSQL_PARSER_STATEMENT_H
+
+#include "mysql_ast.h" // Uses MysqlParser::AstNode
+#include <cstdint>
+
+namespace MysqlParser {
+
+// Typed views of a statement's clauses: one nullable field per clause,
+// pointing into the AstNode tree, so finding a clause is a field read rather
+// than a scan of children. A clause the statement does not have is nullptr;
+// the tree itself has no placeholder node for it either.
+//
+// The AstNode tree stays the representation for generic traversal
+// (AstVisitor, printing, serialization); absent clauses are simply missing
+// from children, and present ones appear in the order of the fields below.
+
+struct SelectStmt {
+    const AstNode* options = nullptr;  // NODE_SELECT_OPTIONS: DISTINCT, ALL
+    const AstNode* items = nullptr;    // NODE_SELECT_ITEM_LIST
+    const AstNode* into = nullptr;     // NODE_INTO_OUTFILE, NODE_INTO_DUMPFILE or NODE_INTO_VAR_LIST
+    const AstNode* from = nullptr;     // NODE_FROM_CLAUSE
+    const AstNode* where = nullptr;    // NODE_WHERE_CLAUSE
+    const AstNode* group_by = nullptr; // NODE_GROUP_BY_CLAUSE
+    const AstNode* having = nullptr;   // NODE_HAVING_CLAUSE
+    const AstNode* order_by = nullptr; // NODE_ORDER_BY_CLAUSE
+    const AstNode* limit = nullptr;    // NODE_LIMIT_CLAUSE
+    const AstNode* locking = nullptr;  // NODE_LOCKING_CLAUSE_LIST
+};
+
+struct InsertStmt {
+    const AstNode* table = nullptr;   // NODE_IDENTIFIER or NODE_QUALIFIED_IDENTIFIER
+    const AstNode* columns = nullptr; // NODE_COLUMN_LIST
+    const AstNode* values = nullptr;  // NODE_VALUES_CLAUSE
+};
+
+// Single-table DELETE sets table; the multi-table forms set targets and
+// one of from or using_tables instead.
+struct DeleteStmt {
+    const AstNode* options = nullptr;      // NODE_DELETE_OPTIONS: LOW_PRIORITY, QUICK, IGNORE
+    const AstNode* table = nullptr;        // NODE_IDENTIFIER or NODE_QUALIFIED_IDENTIFIER
+    const AstNode* targets = nullptr;      // NODE_TABLE_NAME_LIST
+    const AstNode* from = nullptr;         // NODE_FROM_CLAUSE: DELETE t1, t2 FROM <tables>
+    const AstNode* using_tables = nullptr; // NODE_USING_CLAUSE: DELETE FROM t1, t2 USING <tables>
+    const AstNode* where = nullptr;        // NODE_WHERE_CLAUSE
+    const AstNode* order_by = nullptr;     // NODE_ORDER_BY_CLAUSE (single-table only)
+    const AstNode* limit = nullptr;        // NODE_LIMIT_CLAUSE (single-table only)
+};
+
+// Exactly one field is set, by the form of SET
+struct SetStmt {
+    const AstNode* assignments = nullptr; // NODE_VARIABLE_ASSIGNMENT_LIST: SET a = 1, @b = 2
+    const AstNode* names = nullptr;       // NODE_SET_NAMES
+    const AstNode* charset = nullptr;     // NODE_SET_CHARSET
+    const AstNode* transaction = nullptr; // NODE_TXN_CHARACTERISTIC_LIST: SET [scope] TRANSACTION ...
+};
+
+enum class StatementKind : uint8_t {
+    None,   // No statement (empty input or failed parse)
+    Select,
+    Insert,
+    Delete,
+    Set,
+    Other   // QUIT, SHOW, BEGIN, COMMIT: see node
+};
+
+// Only the member matching kind is filled in
+struct Statement {
+    StatementKind kind = StatementKind::None;
+    const AstNode* node = nullptr; // Root of the statement
+    SelectStmt select;
+    InsertStmt insert;
+    DeleteStmt del;
+    SetStmt set;
+};
+
+// Typed view of a statement node from any source: a subquery's
+// NODE_SELECT_STATEMENT, a deserialized tree, a tree parsed earlier. Reads
+// the clauses off node's children in one pass. Parser::getStatement() gives
+// the same view of the last parsed statement without that pass.
+Statement statement_of(const AstNode* node);
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_STATEMENT_H
@@ -0,0 +1,85 @@
+#ifndef MYSQL_PARSER_SYMBOL_TABLE_H
+#define MYSQL_PARSER_SYMBOL_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace MysqlParser {
+
+// Interned identifier: equal names in the same SymbolTable have equal symbols
+using Symbol = uint32_t;
+constexpr Symbol kNoSymbol = 0;
+
+struct SymbolTableOptions {
+    // Distinct names kept; once reached, intern() returns kNoSymbol for new names
+    size_t max_symbols = 1 << 20;
+};
+
+// Maps identifier names to stable 32-bit symbols. Names are never removed,
+// so a symbol stays valid, and name() stays readable without locking, for
+// the lifetime of the table.
+//
+// Thread-safe and meant to be shared read-mostly: lookups of known names
+// take a shared lock on one of 16 shards, and only new names take it
+// exclusively. Parsers additionally cache recent lookups (see
+// Parser::setSymbolTable()), so hot names rarely reach the shards at all.
+//
+// Symbols compare names exactly, as written (after backtick unquoting).
+// folded() gives the symbol of the ASCII lower-cased name for
+// case-insensitive comparisons, e.g. of column names.
+class SymbolTable {
+public:
+    explicit SymbolTable(const SymbolTableOptions& options = SymbolTableOptions());
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    // Symbol for name, adding it if new; kNoSymbol if the table is full. A
+    // name with upper-case letters needs room for its lower-cased form too.
+    Symbol intern(std::string_view name);
+    Symbol intern(std::string_view name, uint64_t hash); // hash is hash_name(name)
+    // kNoSymbol if name was never interned
+    Symbol find(std::string_view name) const;
+
+    // Text of a symbol returned by this table; empty for kNoSymbol
+    std::string_view name(Symbol symbol) const;
+    // Symbol of the ASCII lower-cased name (symbol itself if already lower case)
+    Symbol folded(Symbol symbol) const;
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    // FNV-1a, as used to pick a shard
+    static uint64_t hash_name(std::string_view name);
+
+private:
+    struct Entry {
+        std::string text;
+        Symbol folded;
+    };
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kChunkBits = 10; // Entries per chunk: 1024
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, Symbol> symbols; // Keys point into entries
+    };
+
+    Symbol insert(Shard& shard, std::string_view name, Symbol folded);
+    Entry& entry(Symbol symbol) const;
+
+    SymbolTableOptions options_;
+    Shard shards_[kShards];
+    // Entries live in fixed chunks, so their addresses and the chunk table never change
+    std::unique_ptr<std::atomic<Entry*>[]> chunks_;
+    std::atomic<size_t> size_{0};
+};
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_SYMBOL_TABLE_H
@@ -0,0 +1,112 @@
+#ifndef MYSQL_PARSER_TOKEN_BUFFER_H
+#define MYSQL_PARSER_TOKEN_BUFFER_H
+
+#include "mysql_query_comments.h" // Uses MysqlParser::QueryComments
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MysqlParser {
+
+class ParserContext; // See src/mysql_parser/mysql_parser_internal.h
+
+enum TokenFlags : uint16_t {
+    kTokenIdentifier = 1 << 0, // Plain or backticked identifier
+    kTokenLiteral = 1 << 1,    // Number or string literal
+    kTokenHasValue = 1 << 2,   // Carries a value: identifiers, literals and QUIT
+    kTokenQuoted = 1 << 3,     // Source text is the value in quotes or backticks
+    kTokenStored = 1 << 4,     // Value differs from the source text and is kept in the buffer
+    kTokenEscaped = 1 << 5     // String literal with escapes (AstNode::escaped)
+};
+
+// One token of a lexed query. id is the grammar's token number (the
+// TOKEN_* values of the Bison parser, stable for a build of the grammar);
+// offset and length are the token's bytes in TokenBuffer::query().
+struct Token {
+    uint16_t id;
+    uint16_t flags;  // TokenFlags
+    uint32_t offset;
+    uint32_t length;
+    uint32_t value;  // Index of the stored value when kTokenStored
+};
+
+// A query lexed once into a compact token array, for pipelines that look at
+// the same statement several ways (classification, digest, hints, the full
+// AST): the lightweight passes walk the tokens, and Parser::parse(const
+// TokenBuffer&) feeds them to the grammar without scanning the text again.
+//
+// Reuse one buffer per thread: lex() replaces the contents but keeps every
+// allocation, so a warm buffer only allocates for a query longer than any
+// before it. The Flex scanner is taken from the parsers' shared pool on the
+// first lex(). Not thread-safe; a buffer may be read by any number of
+// threads between calls to lex().
+class TokenBuffer {
+public:
+    TokenBuffer();
+    ~TokenBuffer();
+
+    TokenBuffer(const TokenBuffer&) = delete;
+    TokenBuffer& operator=(const TokenBuffer&) = delete;
+
+    // Copies sql and lexes it to the end. Returns false if the lexer reported
+    // errors (see getErrors()); the tokens it did recognize are kept.
+    bool lex(const std::string& sql);
+    bool lex(const char* sql, size_t len);
+
+    size_t size() const { return tokens_.size(); }
+    bool empty() const { return tokens_.empty(); }
+    const Token& operator[](size_t i) const { return tokens_[i]; }
+    const Token* begin() const { return tokens_.data(); }
+    const Token* end() const { return tokens_.data() + tokens_.size(); }
+
+    // The query given to the last lex()
+    std::string_view query() const { return query_; }
+    // Source bytes of t, quotes included
+    std::string_view text(const Token& t) const { return std::string_view(query_).substr(t.offset, t.length); }
+    // What the grammar sees for t: the identifier without backticks, the
+    // string literal unquoted and unescaped, the number as written. Empty for
+    // tokens without kTokenHasValue.
+    std::string_view value(const Token& t) const;
+
+    // Comments of the whole query, as offsets into query()
+    const QueryComments& getComments() const { return comments_; }
+    // Lexer errors of the whole query (unknown characters, unterminated strings...)
+    const std::vector<std::string>& getErrors() const { return errors_; }
+    // Parser::getDigest() of the whole query, without parsing it
+    uint64_t getDigest() const { return digest_; }
+
+private:
+    friend class ParserContext; // Fills the buffer in lex() and replays it in parse()
+
+    // A side effect of lexing, replayed by the parser just before it reads
+    // token (size() for the end of input), so that a parse that stops early
+    // sees exactly what the scanner would have shown it
+    enum class EventKind : uint8_t { Error, Comments, Node };
+    struct Event {
+        uint32_t token;
+        EventKind kind;
+        uint32_t count;       // Error: index into errors_; Comments: comments seen so far
+        uint32_t annotations; // Comments: annotations seen so far
+    };
+    struct StoredValue {
+        uint32_t offset; // Into values_
+        uint32_t length;
+    };
+
+    std::string query_;
+    std::vector<Token> tokens_;
+    std::string values_;
+    std::vector<StoredValue> stored_;
+    std::vector<Event> events_;
+    std::vector<std::string> errors_;
+    QueryComments comments_;
+    uint64_t digest_ = 0;
+    std::unique_ptr<ParserContext> lexer_; // Scanner state and the lexer's callbacks
+};
+
+} // namespace MysqlParser
+
+#endif // MYSQL_PARSER_TOKEN_BUFFER_H
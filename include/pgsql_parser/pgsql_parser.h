@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 typedef void* yyscan_t;
 
@@ -23,11 +24,14 @@ public:
     void internal_set_ast(AstNode* root);
     void internal_add_error(const std::string& msg);
     void internal_add_error_at(const std::string& msg, int line, int column);
+    // Reports the first byte of each run of bytes that are not valid UTF-8
+    void internal_invalid_utf8_byte(size_t offset);
 
 private:
     std::unique_ptr<AstNode> ast_root_;
     std::vector<std::string> errors_;
     yyscan_t scanner_state_;
+    size_t invalid_utf8_end_ = SIZE_MAX; // Offset just past the last invalid byte
 };
 
 } // namespace PgsqlParser
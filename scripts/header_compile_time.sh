@@ -0,0 +1,49 @@
+#!/bin/bash
+# Compile time of translation units that depend on the parser headers: one
+# that includes only mysql_parser.h and one that also includes mysql_ast.h,
+# each compiled with the Makefile's flags.
+#
+# Usage: header_compile_time.sh [-n RUNS] [ROOT]
+#   -n     Compile each TU RUNS times (default 20) and report min and median
+#   ROOT   Tree whose include/ is used (default: this script's repository),
+#          e.g. a `git worktree` of an older revision for a before/after
+set -e
+
+RUNS=20
+ROOT=""
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) RUNS="$2"; shift 2 ;;
+        -*) echo "Unknown argument: $1" >&2; exit 1 ;;
+        *) ROOT="$1"; shift ;;
+    esac
+done
+ROOT=$(readlink -f "${ROOT:-$(dirname "$0")/..}")
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++17 -Wall -g -O2}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+cat > "$WORK/parser_only.cpp" <<'EOF'
+#include "mysql_parser/mysql_parser.h"
+bool parses(MysqlParser::Parser& parser, const std::string& sql) { return parser.parse(sql) != nullptr; }
+EOF
+cat > "$WORK/parser_and_ast.cpp" <<'EOF'
+#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser/mysql_ast.h"
+bool parses(MysqlParser::Parser& parser, const std::string& sql) { return parser.parse(sql) != nullptr; }
+EOF
+
+echo "$("$CXX" --version | head -1), $CXXFLAGS, $RUNS runs, $ROOT"
+for tu in parser_only parser_and_ast; do
+    times=()
+    for ((i = 0; i < RUNS; ++i)); do
+        start=$(date +%s%N)
+        $CXX $CXXFLAGS -I"$ROOT/include" -c "$WORK/$tu.cpp" -o "$WORK/$tu.o"
+        times+=($((($(date +%s%N) - start) / 1000000)))
+    done
+    sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+    lines=$($CXX $CXXFLAGS -I"$ROOT/include" -E "$WORK/$tu.cpp" | wc -l)
+    printf '%-15s min %4d ms, median %4d ms, %6d preprocessed lines\n' \
+        "$tu" "${sorted[0]}" "${sorted[$((RUNS / 2))]}" "$lines"
+done
@@ -0,0 +1,39 @@
+#!/bin/bash
+# CPU profile and tracepoint counts for the parsers with perf. Build with
+# `make profile` (frame pointers) so call graphs unwind without DWARF.
+#
+# Usage: parser_perf.sh BINARY [-- COMMAND...]
+#   Registers the mysqlparser and pgsqlparser USDT probes of BINARY with perf,
+#   then runs COMMAND (default: BINARY alone) twice: once under `perf stat`
+#   counting every probe (parses, tokens, nodes, statements, errors), and once
+#   under `perf record -g --call-graph fp`, leaving perf.data for
+#   `perf report --no-children`, where time splits across mysql_yylex_raw
+#   (lexing), mysql_yyparse (grammar and tree construction),
+#   MysqlParser::AstNode::~AstNode (teardown) and the fast path.
+set -e
+
+if [ $# -lt 1 ]; then
+    sed -n '5,12p' "$0" | sed 's/^# \{0,1\}//'
+    exit 1
+fi
+BINARY=$(readlink -f "$1")
+shift
+if [ "$1" = "--" ]; then shift; fi
+if [ $# -eq 0 ]; then set -- "$BINARY"; fi
+
+perf buildid-cache --add "$BINARY"
+EVENTS=()
+for provider in mysqlparser pgsqlparser; do
+    if perf list "sdt_$provider:*" 2>/dev/null | grep -q "sdt_$provider:"; then
+        perf probe -q -d "sdt_$provider:*" 2>/dev/null || true
+        perf probe -q -a "sdt_$provider:*"
+        EVENTS+=(-e "sdt_$provider:*")
+    fi
+done
+if [ ${#EVENTS[@]} -eq 0 ]; then
+    echo "No parser tracepoints in $BINARY (built without <sys/sdt.h>, or USDT=0?)" >&2
+else
+    perf stat "${EVENTS[@]}" -- "$@"
+fi
+perf record -g --call-graph fp -o perf.data -- "$@"
+echo "Profile written to perf.data; see: perf report --no-children --sort symbol"
@@ -0,0 +1,116 @@
+#!/bin/bash
+# Per-phase latency breakdown of the parsers from their USDT tracepoints
+# (src/mysql_parser/mysql_trace.h, src/pgsql_parser/pgsql_trace.h), using
+# bpftrace. Needs root, and a binary linked against the parser's library
+# built with <sys/sdt.h> available.
+#
+# Usage: parser_phases.sh BINARY [-P PROVIDER] [-p PID | -c "COMMAND"] [-d SECONDS]
+#   BINARY   Executable (or shared object) holding the parser
+#   -P       mysqlparser (default) or pgsqlparser
+#   -p PID   Trace a running process; -c runs COMMAND and traces it
+#   -d       Stop after SECONDS; otherwise at Ctrl-C or when COMMAND exits
+# Set LEX=0 to skip the per-token lex_* probes: each attached probe costs a
+# trap per token, which inflates the lexing figure and the parse total.
+#
+# Reports, in nanoseconds: total parse time, time in the fast path, buffer
+# setup, lexing (summed over tokens), grammar including tree construction
+# (grammar time minus lexing), buffer teardown and tree teardown; plus
+# statements by node type, nodes built per parse and failed parses by status.
+# The PostgreSQL parser has no fast path, lexer, node or tree teardown
+# probes: its grammar figure includes lexing, and errors are keyed by message.
+set -e
+
+if [ $# -lt 1 ]; then
+    sed -n '7,14p' "$0" | sed 's/^# \{0,1\}//'
+    exit 1
+fi
+BINARY=$(readlink -f "$1")
+shift
+TARGET=()
+DURATION=""
+PROVIDER=mysqlparser
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -P) PROVIDER="$2"; shift 2 ;;
+        -p) TARGET=(-p "$2"); shift 2 ;;
+        -c) TARGET=(-c "$2"); shift 2 ;;
+        -d) DURATION="$2"; shift 2 ;;
+        *) echo "Unknown argument: $1" >&2; exit 1 ;;
+    esac
+done
+
+P="usdt:$BINARY:$PROVIDER"
+# Probes only the MySQL parser has, and where the two put their arguments
+case "$PROVIDER" in
+    mysqlparser)
+        STATEMENT_TYPE=arg1; ERROR_KEY="arg0, str(arg1)"; TREE=arg1
+        NODES_PER_PARSE="@nodes_per_parse = hist(@nodes[tid]);"
+        MYSQL_CLEAR="clear(@fast_at); clear(@tree_teardown_at);"
+        MYSQL_PROBES="
+$P:fast_path_start { @fast_at[tid] = nsecs; }
+$P:fast_path_done /@fast_at[tid]/ {
+    @phase_ns[\"fast path\"] = hist(nsecs - @fast_at[tid]);
+    @fast_path[arg0 ? \"hit\" : \"miss\"] = count();
+    delete(@fast_at[tid]);
+}
+$P:node_new { @nodes[tid]++; }
+$P:teardown_start { @tree_teardown_at[tid] = nsecs; }
+$P:teardown_done /@tree_teardown_at[tid]/ {
+    @phase_ns[\"tree teardown\"] = hist(nsecs - @tree_teardown_at[tid]);
+    delete(@tree_teardown_at[tid]);
+}"
+        if [ "${LEX:-1}" != "0" ]; then
+            MYSQL_PROBES="$MYSQL_PROBES
+$P:lex_start { @lex_at[tid] = nsecs; }
+$P:lex_done /@lex_at[tid]/ { @lex_ns[tid] += nsecs - @lex_at[tid]; delete(@lex_at[tid]); }"
+            MYSQL_CLEAR="$MYSQL_CLEAR clear(@lex_at);"
+        fi
+        ;;
+    pgsqlparser)
+        STATEMENT_TYPE=arg0; ERROR_KEY="str(arg0)"; TREE=arg0
+        NODES_PER_PARSE=""
+        MYSQL_CLEAR=""
+        MYSQL_PROBES=""
+        ;;
+    *) echo "Unknown provider: $PROVIDER (mysqlparser or pgsqlparser)" >&2; exit 1 ;;
+esac
+STOP=""
+if [ -n "$DURATION" ]; then
+    STOP="interval:s:$DURATION { exit(); }"
+fi
+
+exec bpftrace "${TARGET[@]}" -e "
+$P:parse_start { @parse_at[tid] = nsecs; @lex_ns[tid] = 0; @nodes[tid] = 0; }
+$P:buffer_setup_start { @setup_at[tid] = nsecs; }
+$P:buffer_setup_done /@setup_at[tid]/ {
+    @phase_ns[\"buffer setup\"] = hist(nsecs - @setup_at[tid]);
+    @grammar_at[tid] = nsecs;
+    delete(@setup_at[tid]);
+}
+$MYSQL_PROBES
+$P:statement { @statements[$STATEMENT_TYPE] = count(); }
+$P:grammar_done /@grammar_at[tid]/ {
+    \$grammar = nsecs - @grammar_at[tid];
+    \$lex = @lex_ns[tid];
+    if (\$lex > 0) { @phase_ns[\"lexing\"] = hist(\$lex); }
+    @phase_ns[\"grammar + tree construction\"] = hist(\$grammar > \$lex ? \$grammar - \$lex : 0);
+    @teardown_buffer_at[tid] = nsecs;
+    delete(@grammar_at[tid]);
+}
+$P:buffer_teardown_done /@teardown_buffer_at[tid]/ {
+    @phase_ns[\"buffer teardown\"] = hist(nsecs - @teardown_buffer_at[tid]);
+    delete(@teardown_buffer_at[tid]);
+}
+$P:parse_error { @errors[$ERROR_KEY] = count(); }
+$P:parse_done /@parse_at[tid]/ {
+    @phase_ns[\"parse total\"] = hist(nsecs - @parse_at[tid]);
+    $NODES_PER_PARSE
+    @parses[$TREE ? \"tree\" : \"no tree\"] = count();
+    delete(@parse_at[tid]); delete(@lex_ns[tid]); delete(@nodes[tid]);
+}
+$STOP
+END {
+    clear(@parse_at); clear(@setup_at); clear(@grammar_at); clear(@lex_ns); clear(@nodes);
+    clear(@teardown_buffer_at); $MYSQL_CLEAR
+}
+"
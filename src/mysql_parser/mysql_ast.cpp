@@ -0,0 +1,24 @@
+#include "mysql_parser/mysql_ast.h"
+#include "mysql_trace.h"
+
+namespace MysqlParser {
+
+AstNode::~AstNode() {
+    // Nodes deleted below have had their children taken, so the probes fire
+    // once per tree rather than once per node
+    if (children.empty()) return;
+    MYSQL_TRACE(teardown_start);
+    std::vector<AstNode*> pending;
+    pending.swap(children);
+    while (!pending.empty()) {
+        AstNode* node = pending.back();
+        pending.pop_back();
+        if (!node) continue;
+        pending.insert(pending.end(), node->children.begin(), node->children.end());
+        node->children.clear();
+        delete node;
+    }
+    MYSQL_TRACE(teardown_done);
+}
+
+} // namespace MysqlParser
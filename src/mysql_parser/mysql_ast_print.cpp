@@ -0,0 +1,122 @@
+#include "mysql_parser/mysql_ast_print.h"
+#include <iostream>
+
+namespace MysqlParser {
+
+const char* node_type_name(NodeType type) {
+    switch (type) {
+        case NodeType::NODE_UNKNOWN: return "UNKNOWN";
+        case NodeType::NODE_COMMAND: return "COMMAND";
+        case NodeType::NODE_SELECT_STATEMENT: return "SELECT_STMT";
+        case NodeType::NODE_INSERT_STATEMENT: return "INSERT_STMT";
+        case NodeType::NODE_DELETE_STATEMENT: return "DELETE_STMT";
+        case NodeType::NODE_IDENTIFIER: return "IDENTIFIER";
+        case NodeType::NODE_STRING_LITERAL: return "STRING_LITERAL";
+        case NodeType::NODE_NUMBER_LITERAL: return "NUMBER_LITERAL";
+        case NodeType::NODE_ASTERISK: return "ASTERISK";
+        case NodeType::NODE_SET_STATEMENT: return "SET_STATEMENT";
+        case NodeType::NODE_VARIABLE_ASSIGNMENT: return "VAR_ASSIGN";
+        case NodeType::NODE_USER_VARIABLE: return "USER_VAR";
+        case NodeType::NODE_SYSTEM_VARIABLE: return "SYSTEM_VAR";
+        case NodeType::NODE_VARIABLE_SCOPE: return "VAR_SCOPE";
+        case NodeType::NODE_EXPRESSION_PLACEHOLDER: return "EXPR_PLACEHOLDER";
+        case NodeType::NODE_SIMPLE_EXPRESSION: return "SIMPLE_EXPRESSION";
+        case NodeType::NODE_AGGREGATE_FUNCTION_CALL: return "AGGREGATE_FUNC_CALL";
+        case NodeType::NODE_SET_NAMES: return "SET_NAMES";
+        case NodeType::NODE_SET_CHARSET: return "SET_CHARSET";
+        case NodeType::NODE_DELETE_OPTIONS: return "DELETE_OPTIONS";
+        case NodeType::NODE_TABLE_NAME_LIST: return "TABLE_NAME_LIST";
+        case NodeType::NODE_FROM_CLAUSE: return "FROM_CLAUSE";
+        case NodeType::NODE_USING_CLAUSE: return "USING_CLAUSE";
+        case NodeType::NODE_WHERE_CLAUSE: return "WHERE_CLAUSE";
+        case NodeType::NODE_HAVING_CLAUSE: return "HAVING_CLAUSE";
+        case NodeType::NODE_ORDER_BY_CLAUSE: return "ORDER_BY_CLAUSE";
+        case NodeType::NODE_ORDER_BY_ITEM: return "ORDER_BY_ITEM";
+        case NodeType::NODE_LIMIT_CLAUSE: return "LIMIT_CLAUSE";
+        case NodeType::NODE_COMPARISON_EXPRESSION: return "COMPARISON_EXPR";
+        case NodeType::NODE_LOGICAL_AND_EXPRESSION: return "LOGICAL_AND_EXPR";
+        case NodeType::NODE_OPERATOR: return "OPERATOR";
+        case NodeType::NODE_QUALIFIED_IDENTIFIER: return "QUALIFIED_IDENTIFIER";
+        case NodeType::NODE_SELECT_OPTIONS: return "SELECT_OPTIONS";
+        case NodeType::NODE_SELECT_ITEM_LIST: return "SELECT_ITEM_LIST";
+        case NodeType::NODE_SELECT_ITEM: return "SELECT_ITEM";
+        case NodeType::NODE_ALIAS: return "ALIAS";
+        case NodeType::NODE_TABLE_REFERENCE: return "TABLE_REFERENCE";
+        case NodeType::NODE_GROUP_BY_CLAUSE: return "GROUP_BY_CLAUSE";
+        case NodeType::NODE_GROUPING_ELEMENT: return "GROUPING_ELEMENT";
+        case NodeType::NODE_JOIN_CLAUSE: return "JOIN_CLAUSE";
+        case NodeType::NODE_JOIN_TYPE_NATURAL_SPEC: return "JOIN_TYPE_NATURAL_SPEC";
+        case NodeType::NODE_JOIN_CONDITION_ON: return "JOIN_CONDITION_ON";
+        case NodeType::NODE_JOIN_CONDITION_USING: return "JOIN_CONDITION_USING";
+        case NodeType::NODE_COLUMN_LIST: return "COLUMN_LIST";
+        case NodeType::NODE_INTO_CLAUSE: return "INTO_CLAUSE";
+        case NodeType::NODE_INTO_VAR_LIST: return "INTO_VAR_LIST";
+        case NodeType::NODE_INTO_OUTFILE: return "INTO_OUTFILE";
+        case NodeType::NODE_INTO_DUMPFILE: return "INTO_DUMPFILE";
+        case NodeType::NODE_LOCKING_CLAUSE_LIST: return "LOCKING_CLAUSE_LIST";
+        case NodeType::NODE_LOCKING_CLAUSE: return "LOCKING_CLAUSE";
+        case NodeType::NODE_LOCK_STRENGTH: return "LOCK_STRENGTH";
+        case NodeType::NODE_LOCK_TABLE_LIST: return "LOCK_TABLE_LIST";
+        case NodeType::NODE_LOCK_OPTION: return "LOCK_OPTION";
+        case NodeType::NODE_DERIVED_TABLE: return "DERIVED_TABLE";
+        case NodeType::NODE_SUBQUERY: return "SUBQUERY";
+        case NodeType::NODE_FILE_OPTIONS: return "FILE_OPTIONS";
+        case NodeType::NODE_FIELDS_OPTIONS_CLAUSE: return "FIELDS_OPTIONS_CLAUSE";
+        case NodeType::NODE_LINES_OPTIONS_CLAUSE: return "LINES_OPTIONS_CLAUSE";
+        case NodeType::NODE_FIELDS_TERMINATED_BY: return "FIELDS_TERMINATED_BY";
+        case NodeType::NODE_FIELDS_ENCLOSED_BY: return "FIELDS_ENCLOSED_BY";
+        case NodeType::NODE_FIELDS_OPTIONALLY_ENCLOSED_BY: return "FIELDS_OPTIONALLY_ENCLOSED_BY";
+        case NodeType::NODE_FIELDS_ESCAPED_BY: return "FIELDS_ESCAPED_BY";
+        case NodeType::NODE_LINES_STARTING_BY: return "LINES_STARTING_BY";
+        case NodeType::NODE_LINES_TERMINATED_BY: return "LINES_TERMINATED_BY";
+        case NodeType::NODE_CHARSET_OPTION: return "CHARSET_OPTION";
+        case NodeType::NODE_KEYWORD: return "KEYWORD";
+        case NodeType::NODE_SHOW_STATEMENT: return "SHOW_STMT";
+        case NodeType::NODE_BEGIN_STATEMENT: return "BEGIN_STMT";
+        case NodeType::NODE_COMMIT_STATEMENT: return "COMMIT_STMT";
+        case NodeType::NODE_SHOW_OPTION_FULL: return "SHOW_OPT_FULL";
+        case NodeType::NODE_SHOW_OPTION_FIELDS: return "SHOW_OPT_FIELDS";
+        case NodeType::NODE_SHOW_TARGET_DATABASES: return "SHOW_TARGET_DB";
+        case NodeType::NODE_TABLE_SPECIFICATION: return "TABLE_SPEC";
+        case NodeType::NODE_IS_NULL_EXPRESSION: return "IS_NULL_EXPR";
+        case NodeType::NODE_IS_NOT_NULL_EXPRESSION: return "IS_NOT_NULL_EXPR";
+        case NodeType::NODE_EXPRESSION_LIST: return "EXPR_LIST";
+        case NodeType::NODE_VALUE_ROW_LIST: return "VALUE_ROW_LIST";
+        case NodeType::NODE_VALUES_CLAUSE: return "VALUES_CLAUSE";
+        case NodeType::NODE_VARIABLE_ASSIGNMENT_LIST: return "VAR_ASSIGN_LIST";
+        case NodeType::NODE_TXN_CHARACTERISTIC_LIST: return "TXN_CHAR_LIST";
+        case NodeType::NODE_TXN_ISOLATION_LEVEL: return "TXN_ISOLATION_LEVEL";
+        case NodeType::NODE_MATCH_AGAINST_EXPRESSION: return "MATCH_AGAINST_EXPR";
+        case NodeType::NODE_FUNCTION_CALL: return "FUNC_CALL";
+        case NodeType::NODE_IN_EXPRESSION: return "IN_EXPR";
+        case NodeType::NODE_TYPE_COUNT: break;
+    }
+    return nullptr;
+}
+
+void print_ast(std::ostream& os, const AstNode* node, int indent) {
+    if (!node) return;
+
+    for (int i = 0; i < indent; ++i) os << "  ";
+
+    const char* type_name = node_type_name(node->type);
+    if (type_name) {
+        os << "Type: " << type_name;
+    } else {
+        os << "Type: UNHANDLED_TYPE(" << static_cast<int>(node->type) << ")";
+    }
+    if (!node->value.empty()) {
+        os << ", Value: '" << node->value << "'";
+    }
+    os << std::endl;
+
+    for (const AstNode* child : node->children) {
+        print_ast(os, child, indent + 1);
+    }
+}
+
+void print_ast(const AstNode* node, int indent) {
+    print_ast(std::cout, node, indent);
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,221 @@
+#include "mysql_parser/mysql_ast_reclaimer.h"
+#include <algorithm>
+#include <chrono>
+
+namespace MysqlParser {
+
+namespace {
+
+std::atomic<uint64_t> next_reclaimer_id{1};
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+// Bounded single-producer/single-consumer ring of retired trees. The owning
+// thread pushes without locks or read-modify-write operations; consumers are
+// serialized by AstReclaimer::mutex_. head and tail only ever grow; their
+// difference is the number of queued trees.
+struct AstReclaimer::ProducerQueue {
+    ProducerQueue(uint64_t owner_id, size_t capacity)
+        : owner(owner_id), mask(capacity - 1), slots(new AstNode*[capacity]) {}
+
+    ~ProducerQueue() {
+        while (pop(SIZE_MAX) > 0) {}
+    }
+
+    // Producer side
+    bool push(AstNode* tree) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head > mask) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t - cached_head > mask) return false;
+        }
+        slots[t & mask] = tree;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    // Only reads head (the consumer's cache line) when the cached view says yes
+    bool backlogAtLeast(size_t n) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head < n) return false;
+        cached_head = head.load(std::memory_order_acquire);
+        return t - cached_head >= n;
+    }
+    static void bump(std::atomic<uint64_t>& counter) { // Single writer, so no RMW needed
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Consumer side
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+    }
+    // Deletes up to max_trees queued trees and returns how many
+    size_t pop(size_t max_trees) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t n = std::min(tail.load(std::memory_order_acquire) - h, max_trees);
+        for (size_t i = 0; i < n; ++i) delete slots[(h + i) & mask];
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    const uint64_t owner; // AstReclaimer::id_
+    const size_t mask;
+    std::unique_ptr<AstNode*[]> slots;
+    std::atomic<bool> closed{false}; // Set when the owning reclaimer is destroyed
+
+    // Written by the producer only
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+    std::atomic<uint64_t> retired{0};
+    std::atomic<uint64_t> inline_frees{0};
+
+    // Written by the consumer only
+    alignas(64) std::atomic<size_t> head{0};
+};
+
+AstReclaimer::AstReclaimer(const AstReclaimerOptions& options)
+    : options_(options), id_(next_reclaimer_id.fetch_add(1, std::memory_order_relaxed)) {
+    if (options_.batch_size == 0) options_.batch_size = 1;
+    if (options_.max_backlog_per_thread > 0) {
+        options_.max_backlog_per_thread = round_up_pow2(std::max<size_t>(options_.max_backlog_per_thread, 2));
+    }
+    if (options_.background_thread) {
+        worker_ = std::thread(&AstReclaimer::backgroundLoop, this);
+    }
+}
+
+AstReclaimer::~AstReclaimer() {
+    if (worker_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_cv_.notify_one();
+        worker_.join();
+    }
+    drain(SIZE_MAX);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& queue : queues_) queue->closed.store(true, std::memory_order_release);
+    queues_.clear();
+}
+
+AstReclaimer::ProducerQueue* AstReclaimer::queueForThisThread() {
+    // Queues of the reclaimers this thread has retired into. Usually one entry;
+    // entries of destroyed reclaimers are dropped on the next miss.
+    thread_local std::vector<std::shared_ptr<ProducerQueue>> thread_queues;
+    for (const auto& queue : thread_queues) {
+        if (queue->owner == id_) return queue.get();
+    }
+    thread_queues.erase(std::remove_if(thread_queues.begin(), thread_queues.end(),
+                                       [](const std::shared_ptr<ProducerQueue>& queue) {
+                                           return queue->closed.load(std::memory_order_acquire);
+                                       }),
+                        thread_queues.end());
+    auto queue = std::make_shared<ProducerQueue>(id_, options_.max_backlog_per_thread);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues_.push_back(queue);
+    }
+    thread_queues.push_back(queue);
+    return queue.get();
+}
+
+void AstReclaimer::retire(std::unique_ptr<AstNode> tree) {
+    if (!tree) return;
+    if (options_.max_backlog_per_thread == 0) {
+        tree.reset();
+        return;
+    }
+    ProducerQueue* queue = queueForThisThread();
+    ProducerQueue::bump(queue->retired);
+    if (!queue->push(tree.get())) {
+        ProducerQueue::bump(queue->inline_frees);
+        tree.reset(); // Backlog full: pay for the teardown here rather than grow without bound
+        return;
+    }
+    tree.release();
+    if (worker_.joinable() && queue->backlogAtLeast(options_.max_backlog_per_thread / 2) &&
+        !wake_requested_.load(std::memory_order_relaxed) &&
+        !wake_requested_.exchange(true, std::memory_order_relaxed)) {
+        wake_cv_.notify_one();
+    }
+}
+
+size_t AstReclaimer::reclaim(size_t max_trees) {
+    return drain(max_trees);
+}
+
+size_t AstReclaimer::drain(size_t max_trees) {
+    using clock = std::chrono::steady_clock;
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    bool progress = true;
+    while (progress && total < max_trees) {
+        progress = false;
+        for (const auto& queue : queues_) {
+            if (total >= max_trees) break;
+            if (queue->size() == 0) continue;
+            auto start = clock::now();
+            size_t n = queue->pop(std::min(options_.batch_size, max_trees - total));
+            reclaim_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count(),
+                                  std::memory_order_relaxed);
+            batches_.fetch_add(1, std::memory_order_relaxed);
+            total += n;
+            progress = true;
+        }
+    }
+    reclaimed_.fetch_add(total, std::memory_order_relaxed);
+
+    // Queues of threads that have exited are only referenced from here.
+    // use_count() is a relaxed load: the fence pairs it with the acq_rel
+    // decrement of the exiting thread's reference, so its last ring writes
+    // and counter updates happen before the reads and the destruction below.
+    queues_.erase(std::remove_if(queues_.begin(), queues_.end(),
+                                 [this](const std::shared_ptr<ProducerQueue>& queue) {
+                                     if (queue.use_count() != 1) return false;
+                                     std::atomic_thread_fence(std::memory_order_acquire);
+                                     if (queue->size() != 0) return false;
+                                     exited_retired_ += queue->retired.load(std::memory_order_relaxed);
+                                     exited_inline_frees_ += queue->inline_frees.load(std::memory_order_relaxed);
+                                     return true;
+                                 }),
+                  queues_.end());
+    return total;
+}
+
+void AstReclaimer::backgroundLoop() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (!stopping_) {
+        wake_cv_.wait_for(lock, std::chrono::microseconds(options_.poll_interval_us), [this] {
+            return stopping_ || wake_requested_.load(std::memory_order_relaxed);
+        });
+        wake_requested_.store(false, std::memory_order_relaxed);
+        lock.unlock();
+        drain(SIZE_MAX);
+        lock.lock();
+    }
+}
+
+AstReclaimerStats AstReclaimer::getStats() const {
+    AstReclaimerStats stats;
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.retired = exited_retired_;
+    stats.inline_frees = exited_inline_frees_;
+    for (const auto& queue : queues_) {
+        stats.retired += queue->retired.load(std::memory_order_relaxed);
+        stats.inline_frees += queue->inline_frees.load(std::memory_order_relaxed);
+        stats.backlog += queue->size();
+    }
+    stats.producer_threads = queues_.size();
+    stats.reclaimed = reclaimed_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.reclaim_ns = reclaim_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,300 @@
+#include "mysql_parser/mysql_ast_serialize.h"
+#include <cstring>
+#include <limits>
+
+namespace MysqlParser {
+
+namespace {
+
+const char kMagic[4] = {'M', 'A', 'S', 'T'};
+const uint64_t kFlagEscaped = 1;
+
+size_t varint_size(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+void put_varint(uint8_t*& p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(v);
+}
+
+// For validated data
+inline uint64_t get_varint(const uint8_t*& p) {
+    if (*p < 0x80) return *p++;
+    uint64_t v = *p & 0x7f;
+    for (unsigned shift = 7; *p++ & 0x80; shift += 7) v |= static_cast<uint64_t>(*p & 0x7f) << shift;
+    return v;
+}
+
+// For untrusted data: fails on truncation and on values above 32 bits
+inline bool get_varint_checked(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    if (p != end && *p < 0x80) { // Most fields fit in one byte
+        v = *p++;
+        return true;
+    }
+    v = 0;
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+        if (p == end) return false;
+        uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return v <= std::numeric_limits<uint32_t>::max();
+    }
+    return false;
+}
+
+void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint16_t get_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+// --- AstSerializer ---
+
+size_t AstSerializer::prepare(const AstNode* root) {
+    entries_.clear();
+    pool_.clear();
+    pool_index_.clear();
+    nodes_size_ = 0;
+    if (!root) return 0;
+
+    // Pre-order numbering with an explicit stack; children are pushed in reverse
+    stack_.clear();
+    stack_.emplace_back(root, 0);
+    while (!stack_.empty()) {
+        auto [node, parent] = stack_.back();
+        stack_.pop_back();
+        uint32_t value_offset = 0;
+        if (!node->value.empty()) {
+            auto inserted = pool_index_.emplace(std::string_view(node->value), static_cast<uint32_t>(pool_.size()));
+            if (inserted.second) pool_ += node->value;
+            value_offset = inserted.first->second;
+        }
+        uint32_t index = static_cast<uint32_t>(entries_.size());
+        uint32_t child_count = 0;
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+            if (!*it) continue;
+            stack_.emplace_back(*it, index);
+            ++child_count;
+        }
+        entries_.push_back(Entry{node, parent, value_offset, child_count, 0});
+    }
+    if (pool_.size() > std::numeric_limits<uint32_t>::max()) return 0;
+
+    // Descendants come after their ancestors, so one backwards pass sizes every subtree
+    auto record_size = [](const Entry& e) {
+        size_t len = e.node->value.size();
+        return varint_size(static_cast<uint64_t>(e.node->type)) + 1 + varint_size(len) +
+               (len ? varint_size(e.value_offset) : 0) + varint_size(e.child_count) +
+               varint_size(e.subtree_size) + e.subtree_size;
+    };
+    for (size_t i = entries_.size() - 1; i > 0; --i) {
+        entries_[entries_[i].parent].subtree_size += record_size(entries_[i]);
+    }
+    nodes_size_ = record_size(entries_[0]);
+    if (nodes_size_ > std::numeric_limits<uint32_t>::max()) {
+        entries_.clear();
+        return 0;
+    }
+    return kAstBlobHeaderSize + nodes_size_ + pool_.size();
+}
+
+size_t AstSerializer::write(void* buffer, size_t capacity) const {
+    if (entries_.empty()) return 0;
+    size_t total = kAstBlobHeaderSize + nodes_size_ + pool_.size();
+    if (capacity < total) return 0;
+
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    std::memcpy(out, kMagic, sizeof(kMagic));
+    put_u16(out + 4, kAstFormatVersion);
+    put_u16(out + 6, static_cast<uint16_t>(kNodeTypeCount));
+    put_u32(out + 8, static_cast<uint32_t>(entries_.size()));
+    put_u32(out + 12, static_cast<uint32_t>(nodes_size_));
+    put_u32(out + 16, static_cast<uint32_t>(pool_.size()));
+
+    uint8_t* p = out + kAstBlobHeaderSize;
+    for (const Entry& e : entries_) {
+        size_t len = e.node->value.size();
+        put_varint(p, static_cast<uint64_t>(e.node->type));
+        put_varint(p, e.node->escaped ? kFlagEscaped : 0);
+        put_varint(p, len);
+        if (len) put_varint(p, e.value_offset);
+        put_varint(p, e.child_count);
+        put_varint(p, e.subtree_size);
+    }
+    std::memcpy(p, pool_.data(), pool_.size());
+    return total;
+}
+
+std::string AstSerializer::serialize(const AstNode* root) {
+    std::string out(prepare(root), '\0');
+    write(&out[0], out.size());
+    return out;
+}
+
+// --- AstBlobView ---
+
+AstBlobView::AstBlobView(const void* data, size_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    if (!bytes || len < kAstBlobHeaderSize || std::memcmp(bytes, kMagic, sizeof(kMagic)) != 0) {
+        error_ = "Not a serialized AST";
+        return;
+    }
+    if (get_u16(bytes + 4) != kAstFormatVersion) {
+        error_ = "Unsupported AST format version " + std::to_string(get_u16(bytes + 4));
+        return;
+    }
+    if (get_u16(bytes + 6) != kNodeTypeCount) {
+        error_ = "AST was serialized with a different set of node types";
+        return;
+    }
+    uint64_t node_count = get_u32(bytes + 8);
+    uint64_t nodes_size = get_u32(bytes + 12);
+    uint64_t pool_size = get_u32(bytes + 16);
+    if (kAstBlobHeaderSize + nodes_size + pool_size > len) {
+        error_ = "Serialized AST is truncated";
+        return;
+    }
+    const uint8_t* nodes = bytes + kAstBlobHeaderSize;
+    const uint8_t* nodes_end = nodes + nodes_size;
+
+    // One pass over all records, checking that each one's descendants exactly
+    // fill the byte range and child count it declares
+    struct Frame {
+        const uint8_t* end;
+        uint64_t remaining;
+    };
+    std::vector<Frame> open;
+    open.reserve(32);
+    const uint8_t* p = nodes;
+    uint64_t seen = 0;
+    do {
+        const uint8_t* limit = open.empty() ? nodes_end : open.back().end;
+        uint64_t type, flags, value_len, value_offset = 0, child_count, subtree_size;
+        if (!get_varint_checked(p, limit, type) || !get_varint_checked(p, limit, flags) ||
+            !get_varint_checked(p, limit, value_len) ||
+            (value_len && !get_varint_checked(p, limit, value_offset)) ||
+            !get_varint_checked(p, limit, child_count) || !get_varint_checked(p, limit, subtree_size)) {
+            error_ = "Malformed node record";
+            return;
+        }
+        if (type >= kNodeTypeCount || flags & ~kFlagEscaped || value_offset + value_len > pool_size ||
+            subtree_size > static_cast<uint64_t>(limit - p) || (child_count == 0) != (subtree_size == 0)) {
+            error_ = "Invalid node record";
+            return;
+        }
+        ++seen;
+        if (!open.empty()) --open.back().remaining;
+        if (child_count) open.push_back(Frame{p + subtree_size, child_count});
+        while (!open.empty() && p == open.back().end) {
+            if (open.back().remaining != 0) break;
+            open.pop_back();
+        }
+        if (!open.empty() && (open.back().remaining == 0 || p == open.back().end)) {
+            error_ = "Child count does not match node records";
+            return;
+        }
+    } while (!open.empty());
+    if (p != nodes_end || seen != node_count) {
+        error_ = "Node records do not match the header";
+        return;
+    }
+
+    nodes_ = nodes;
+    nodes_end_ = nodes_end;
+    pool_ = reinterpret_cast<const char*>(nodes_end);
+    node_count_ = node_count;
+    size_ = kAstBlobHeaderSize + nodes_size + pool_size;
+}
+
+AstNodeView AstBlobView::root() const {
+    if (!nodes_) return AstNodeView();
+    return AstNodeView(nodes_, nodes_end_, pool_);
+}
+
+// --- AstNodeView ---
+
+AstNodeView::AstNodeView(const uint8_t* record, const uint8_t* siblings_end, const char* pool)
+    : record_(record), siblings_end_(siblings_end), pool_(pool) {
+    const uint8_t* p = record;
+    type_ = static_cast<NodeType>(get_varint(p));
+    escaped_ = (get_varint(p) & kFlagEscaped) != 0;
+    value_len_ = static_cast<uint32_t>(get_varint(p));
+    value_ = value_len_ ? pool + get_varint(p) : pool;
+    child_count_ = static_cast<uint32_t>(get_varint(p));
+    uint64_t subtree_size = get_varint(p);
+    children_ = p;
+    subtree_end_ = p + subtree_size;
+}
+
+AstNodeView AstNodeView::firstChild() const {
+    if (!child_count_) return AstNodeView();
+    return AstNodeView(children_, subtree_end_, pool_);
+}
+
+AstNodeView AstNodeView::nextSibling() const {
+    if (!record_ || subtree_end_ >= siblings_end_) return AstNodeView();
+    return AstNodeView(subtree_end_, siblings_end_, pool_);
+}
+
+AstNodeView AstNodeView::child(size_t i) const {
+    if (i >= child_count_) return AstNodeView();
+    AstNodeView c = firstChild();
+    while (i--) c = c.nextSibling();
+    return c;
+}
+
+std::unique_ptr<AstNode> AstNodeView::materialize() const {
+    if (!record_) return nullptr;
+    auto make = [](const AstNodeView& v) {
+        AstNode* node = new AstNode(v.type_, std::string(v.value_, v.value_len_));
+        node->escaped = v.escaped_;
+        node->children.reserve(v.child_count_);
+        return node;
+    };
+    std::unique_ptr<AstNode> root(make(*this));
+    // Breadth-first, so each parent receives its children in order
+    std::vector<std::pair<AstNodeView, AstNode*>> work;
+    work.emplace_back(*this, root.get());
+    for (size_t i = 0; i < work.size(); ++i) {
+        AstNode* parent = work[i].second;
+        for (AstNodeView c = work[i].first.firstChild(); c; c = c.nextSibling()) {
+            AstNode* node = make(c);
+            parent->addChild(node);
+            if (c.child_count_) work.emplace_back(c, node);
+        }
+    }
+    return root;
+}
+
+std::unique_ptr<AstNode> deserialize_ast(const void* data, size_t len, std::string* error) {
+    AstBlobView view(data, len);
+    if (!view.valid()) {
+        if (error) *error = view.error();
+        return nullptr;
+    }
+    return view.root().materialize();
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,286 @@
+#include "mysql_parser/mysql_bulk_parser.h"
+#include "mysql_parser/mysql_parser.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MysqlParser {
+
+namespace {
+
+// Statements are handed out to workers in chunks to keep the shared counter cold
+const size_t kChunkSize = 32;
+// Number of chunks per worker that may be parsed ahead of the in-order consumer
+const size_t kChunksAheadPerThread = 4;
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// "DELIMITER" followed by a blank, any case: the mysql client command
+bool is_delimiter_command(const char* p, const char* end) {
+    static const char kCommand[] = "DELIMITER";
+    const size_t n = sizeof(kCommand) - 1;
+    if (static_cast<size_t>(end - p) <= n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if ((p[i] & ~0x20) != kCommand[i]) return false;
+    }
+    return p[n] == ' ' || p[n] == '\t';
+}
+
+// A chunk of consecutive results, published to the consumer as a unit
+struct ChunkSlot {
+    std::vector<BulkParseResult> results;
+    bool ready = false;
+};
+
+} // namespace
+
+BulkParser::BulkParser(unsigned num_threads) : num_threads_(num_threads) {
+    if (num_threads_ == 0) {
+        num_threads_ = std::thread::hardware_concurrency();
+        if (num_threads_ == 0) num_threads_ = 1;
+    }
+}
+
+std::vector<StatementSpan> BulkParser::splitStatements(const char* data, size_t len) {
+    std::vector<StatementSpan> spans;
+    size_t start = 0;     // Start of the current piece
+    bool has_code = false; // Piece contains something other than whitespace/comments
+    size_t i = 0;
+    std::string_view delimiter; // Set by DELIMITER; empty while it is ';'
+
+    auto emit = [&](size_t end) { // end is exclusive
+        if (has_code) {
+            size_t b = start;
+            while (b < end && is_space(data[b])) ++b;
+            size_t e = end;
+            while (e > b && is_space(data[e - 1])) --e;
+            spans.push_back(StatementSpan{b, e - b});
+        }
+        start = end;
+        has_code = false;
+    };
+
+    while (i < len) {
+        char c = data[i];
+        if (!has_code && (c == 'D' || c == 'd') && is_delimiter_command(data + i, data + len)) {
+            // Client command, not a statement: takes the rest of the line
+            size_t p = i + 9;
+            while (p < len && (data[p] == ' ' || data[p] == '\t')) ++p;
+            size_t token = p;
+            while (p < len && !is_space(data[p])) ++p;
+            if (p > token) {
+                delimiter = std::string_view(data + token, p - token);
+                if (delimiter == ";") delimiter = std::string_view();
+            }
+            const void* nl = std::memchr(data + p, '\n', len - p);
+            i = nl ? static_cast<const char*>(nl) - data + 1 : len;
+            start = i;
+            continue;
+        }
+        if (!delimiter.empty() && c == delimiter[0] && len - i >= delimiter.size() &&
+            std::memcmp(data + i, delimiter.data(), delimiter.size()) == 0) {
+            emit(i); // The client strips a custom delimiter before sending the statement
+            i += delimiter.size();
+            start = i;
+            continue;
+        }
+        switch (c) {
+            case '\'':
+            case '"': {
+                has_code = true;
+                ++i;
+                while (i < len && data[i] != c) {
+                    i += (data[i] == '\\' && i + 1 < len) ? 2 : 1;
+                }
+                ++i; // Closing quote; a doubled quote simply reopens the string
+                break;
+            }
+            case '`': {
+                has_code = true;
+                const void* close = (i + 1 < len) ? std::memchr(data + i + 1, '`', len - i - 1) : nullptr;
+                i = close ? static_cast<const char*>(close) - data + 1 : len;
+                break;
+            }
+            case '#': {
+                const void* nl = std::memchr(data + i, '\n', len - i);
+                i = nl ? static_cast<const char*>(nl) - data + 1 : len;
+                break;
+            }
+            case '-':
+                if (i + 1 < len && data[i + 1] == '-' && (i + 2 == len || is_space(data[i + 2]))) {
+                    const void* nl = std::memchr(data + i, '\n', len - i);
+                    i = nl ? static_cast<const char*>(nl) - data + 1 : len;
+                } else {
+                    has_code = true;
+                    ++i;
+                }
+                break;
+            case '/':
+                if (i + 1 < len && data[i + 1] == '*') {
+                    // The server runs versioned comments, so mysqldump's
+                    // /*!50003 CREATE TRIGGER ... */ is a statement
+                    if (i + 2 < len && data[i + 2] == '!') has_code = true;
+                    i += 2;
+                    while (i + 1 < len && !(data[i] == '*' && data[i + 1] == '/')) ++i;
+                    i = (i + 1 < len) ? i + 2 : len;
+                } else {
+                    has_code = true;
+                    ++i;
+                }
+                break;
+            case ';':
+                ++i;
+                if (delimiter.empty()) {
+                    emit(i);
+                } else {
+                    has_code = true;
+                }
+                break;
+            default:
+                if (!is_space(c)) has_code = true;
+                ++i;
+                break;
+        }
+    }
+    emit(len < i ? len : i);
+    return spans;
+}
+
+void BulkParser::parseBuffer(const char* data, size_t len, const BulkParseCallback& callback) {
+    const std::vector<StatementSpan> spans = splitStatements(data, len);
+    const size_t total = spans.size();
+    if (total == 0) return;
+
+    const size_t total_chunks = (total + kChunkSize - 1) / kChunkSize;
+    const size_t ring_size = kChunksAheadPerThread * num_threads_;
+    std::vector<ChunkSlot> ring(ring_size);
+    std::mutex mutex;
+    std::condition_variable chunk_ready;    // Workers -> consumer
+    std::condition_variable chunk_released; // Consumer -> workers
+    std::atomic<size_t> next_chunk(0);
+    size_t delivered_chunks = 0; // Guarded by mutex
+    bool aborted = false;        // Guarded by mutex; set if the callback throws
+
+    auto worker = [&]() {
+        Parser parser;
+        for (;;) {
+            size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= total_chunks) return;
+            {
+                // Do not run further ahead of the consumer than the ring allows
+                std::unique_lock<std::mutex> lock(mutex);
+                chunk_released.wait(lock, [&] { return aborted || chunk < delivered_chunks + ring_size; });
+                if (aborted) return;
+            }
+            ChunkSlot& slot = ring[chunk % ring_size];
+            size_t first = chunk * kChunkSize;
+            size_t last = std::min(first + kChunkSize, total);
+            slot.results.resize(last - first);
+            for (size_t idx = first; idx < last; ++idx) {
+                const StatementSpan& span = spans[idx];
+                BulkParseResult& result = slot.results[idx - first];
+                result.index = idx;
+                result.sql = std::string_view(data + span.offset, span.length);
+                result.ast = parser.parse(data + span.offset, span.length);
+                result.errors = parser.getErrors();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.ready = true;
+            }
+            chunk_ready.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    unsigned n_workers = static_cast<unsigned>(std::min<size_t>(num_threads_, total_chunks));
+    workers.reserve(n_workers);
+    for (unsigned t = 0; t < n_workers; ++t) {
+        workers.emplace_back(worker);
+    }
+
+    // Deliver in input order on the calling thread
+    try {
+        for (size_t chunk = 0; chunk < total_chunks; ++chunk) {
+            ChunkSlot& slot = ring[chunk % ring_size];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                chunk_ready.wait(lock, [&] { return slot.ready; });
+            }
+            for (BulkParseResult& result : slot.results) {
+                callback(result);
+                result.ast.reset();
+                result.errors.clear();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.ready = false;
+                delivered_chunks = chunk + 1;
+            }
+            chunk_released.notify_all();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            aborted = true;
+        }
+        chunk_released.notify_all();
+        for (std::thread& t : workers) t.join();
+        throw;
+    }
+
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+bool BulkParser::parseFile(const std::string& path, const BulkParseCallback& callback) {
+    errors_.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        errors_.push_back("MysqlParser: Cannot open '" + path + "': " + std::strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        errors_.push_back("MysqlParser: Cannot stat '" + path + "': " + std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    size_t len = static_cast<size_t>(st.st_size);
+    if (len == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        errors_.push_back("MysqlParser: Cannot map '" + path + "': " + std::strerror(errno));
+        return false;
+    }
+    ::madvise(map, len, MADV_SEQUENTIAL);
+
+    try {
+        parseBuffer(static_cast<const char*>(map), len, callback);
+    } catch (...) {
+        ::munmap(map, len);
+        throw;
+    }
+    ::munmap(map, len);
+    return true;
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,228 @@
+#include "mysql_parser/mysql_digest_stats.h"
+#include <thread>
+
+namespace MysqlParser {
+
+namespace {
+
+std::atomic<unsigned> next_thread_shard{0};
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Spreads threads over the counter shards round-robin, independently of how
+// many aggregators they record into
+size_t this_thread_shard() {
+    thread_local size_t shard = next_thread_shard.fetch_add(1, std::memory_order_relaxed);
+    return shard;
+}
+
+void atomic_min(std::atomic<uint64_t>& x, uint64_t v) {
+    uint64_t cur = x.load(std::memory_order_relaxed);
+    while (v < cur && !x.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+void atomic_max(std::atomic<uint64_t>& x, uint64_t v) {
+    uint64_t cur = x.load(std::memory_order_relaxed);
+    while (v > cur && !x.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+// One buffer of the aggregator. Slots are claimed by writing their digest
+// with a compare-and-swap and are only released by clear(), once no record()
+// can be writing to the table. Each shard has a counter block per slot.
+struct DigestStatsAggregator::Table {
+    struct Slot {
+        std::atomic<uint64_t> digest{0}; // 0 while free
+        std::atomic<bool> sample_ready{false};
+        std::string sample; // Written once, by the thread that claimed the slot
+    };
+    struct Counters {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> rows{0};
+        std::atomic<uint64_t> total_ns{0};
+        std::atomic<uint64_t> min_ns{UINT64_MAX};
+        std::atomic<uint64_t> max_ns{0};
+    };
+    struct Shard {
+        alignas(64) std::atomic<uint64_t> writers{0}; // record() calls in progress
+        std::atomic<uint64_t> dropped{0};
+        std::unique_ptr<Counters[]> counters;
+    };
+
+    Table(size_t max, size_t shard_count)
+        : max_digests(max),
+          // At most half full, so probes stay short and always reach a free slot
+          mask(round_up_pow2(max * 2 < 2 ? 2 : max * 2) - 1),
+          slots(new Slot[mask + 1]),
+          shards(new Shard[shard_count]),
+          shard_count(shard_count) {
+        for (size_t s = 0; s < shard_count; ++s) shards[s].counters.reset(new Counters[mask + 1]);
+    }
+
+    // Slot holding digest, claiming a free one if needed; SIZE_MAX if the table is full
+    size_t find(uint64_t digest, std::string_view sample, size_t max_sample_bytes) {
+        size_t i = static_cast<size_t>((digest * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+        for (;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            uint64_t current = slot.digest.load(std::memory_order_acquire);
+            if (current == digest) return i;
+            if (current != 0) continue;
+            if (used.load(std::memory_order_relaxed) >= max_digests) return SIZE_MAX;
+            if (used.fetch_add(1, std::memory_order_relaxed) >= max_digests) {
+                used.fetch_sub(1, std::memory_order_relaxed);
+                return SIZE_MAX;
+            }
+            if (slot.digest.compare_exchange_strong(current, digest, std::memory_order_acq_rel)) {
+                if (max_sample_bytes && !sample.empty()) {
+                    slot.sample.assign(sample.data(), sample.size() < max_sample_bytes ? sample.size() : max_sample_bytes);
+                    slot.sample_ready.store(true, std::memory_order_release);
+                }
+                return i;
+            }
+            used.fetch_sub(1, std::memory_order_relaxed);
+            if (current == digest) return i; // Another thread added it first
+        }
+    }
+
+    // Only while no record() can write to this table
+    void clear() {
+        for (size_t i = 0; i <= mask; ++i) {
+            Slot& slot = slots[i];
+            if (slot.digest.load(std::memory_order_relaxed) == 0) continue;
+            slot.digest.store(0, std::memory_order_relaxed);
+            slot.sample_ready.store(false, std::memory_order_relaxed);
+            slot.sample.clear();
+            for (size_t s = 0; s < shard_count; ++s) {
+                Counters& c = shards[s].counters[i];
+                c.calls.store(0, std::memory_order_relaxed);
+                c.errors.store(0, std::memory_order_relaxed);
+                c.rows.store(0, std::memory_order_relaxed);
+                c.total_ns.store(0, std::memory_order_relaxed);
+                c.min_ns.store(UINT64_MAX, std::memory_order_relaxed);
+                c.max_ns.store(0, std::memory_order_relaxed);
+            }
+        }
+        for (size_t s = 0; s < shard_count; ++s) shards[s].dropped.store(0, std::memory_order_relaxed);
+        used.store(0, std::memory_order_relaxed);
+    }
+
+    const size_t max_digests;
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    std::unique_ptr<Shard[]> shards;
+    const size_t shard_count;
+    alignas(64) std::atomic<size_t> used{0}; // Slots claimed, or about to be
+};
+
+DigestStatsAggregator::DigestStatsAggregator(const DigestStatsOptions& options) : options_(options) {
+    size_t shards = options_.shards ? options_.shards : std::thread::hardware_concurrency();
+    options_.shards = round_up_pow2(shards ? shards : 1);
+    shard_mask_ = options_.shards - 1;
+    tables_[0].reset(new Table(options_.max_digests, options_.shards));
+    tables_[1].reset(new Table(options_.max_digests, options_.shards));
+}
+
+DigestStatsAggregator::~DigestStatsAggregator() = default;
+
+void DigestStatsAggregator::record(uint64_t digest, uint64_t latency_ns, uint64_t rows, bool error,
+                                   std::string_view sample) {
+    if (digest == 0) return;
+    size_t s = this_thread_shard() & shard_mask_;
+    for (;;) {
+        // Announce the write before checking the buffer is still current; the
+        // collector flips active_ before reading writers, so one of the two
+        // sees the other (both sequentially consistent)
+        unsigned b = active_.load(std::memory_order_seq_cst);
+        Table& table = *tables_[b];
+        Table::Shard& shard = table.shards[s];
+        shard.writers.fetch_add(1, std::memory_order_seq_cst);
+        if (active_.load(std::memory_order_seq_cst) != b) {
+            shard.writers.fetch_sub(1, std::memory_order_release);
+            continue;
+        }
+
+        size_t i = table.find(digest, sample, options_.max_sample_bytes);
+        if (i == SIZE_MAX) {
+            shard.dropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            Table::Counters& c = shard.counters[i];
+            c.calls.fetch_add(1, std::memory_order_relaxed);
+            if (error) c.errors.fetch_add(1, std::memory_order_relaxed);
+            if (rows) c.rows.fetch_add(rows, std::memory_order_relaxed);
+            c.total_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+            atomic_min(c.min_ns, latency_ns);
+            atomic_max(c.max_ns, latency_ns);
+        }
+        shard.writers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+}
+
+DigestStatsSnapshot DigestStatsAggregator::collect(const Table& table) const {
+    DigestStatsSnapshot out;
+    for (size_t s = 0; s < table.shard_count; ++s) {
+        out.dropped += table.shards[s].dropped.load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i <= table.mask; ++i) {
+        const Table::Slot& slot = table.slots[i];
+        uint64_t digest = slot.digest.load(std::memory_order_acquire);
+        if (digest == 0) continue;
+        DigestStats stats;
+        stats.digest = digest;
+        stats.min_ns = UINT64_MAX;
+        for (size_t s = 0; s < table.shard_count; ++s) {
+            const Table::Counters& c = table.shards[s].counters[i];
+            uint64_t calls = c.calls.load(std::memory_order_relaxed);
+            if (calls == 0) continue;
+            stats.calls += calls;
+            stats.errors += c.errors.load(std::memory_order_relaxed);
+            stats.rows += c.rows.load(std::memory_order_relaxed);
+            stats.total_ns += c.total_ns.load(std::memory_order_relaxed);
+            uint64_t min_ns = c.min_ns.load(std::memory_order_relaxed);
+            uint64_t max_ns = c.max_ns.load(std::memory_order_relaxed);
+            if (min_ns < stats.min_ns) stats.min_ns = min_ns;
+            if (max_ns > stats.max_ns) stats.max_ns = max_ns;
+        }
+        if (stats.calls == 0) continue; // Claimed by a record() still in progress
+        if (stats.min_ns == UINT64_MAX) stats.min_ns = 0; // Counted calls whose minimum is not stored yet
+        if (slot.sample_ready.load(std::memory_order_acquire)) stats.sample = slot.sample;
+        out.digests.push_back(std::move(stats));
+    }
+    return out;
+}
+
+DigestStatsSnapshot DigestStatsAggregator::snapshot() const {
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    return collect(*tables_[active_.load(std::memory_order_acquire)]);
+}
+
+DigestStatsAggregator::Table& DigestStatsAggregator::switchTables() {
+    unsigned old = active_.load(std::memory_order_relaxed);
+    active_.store(old ^ 1, std::memory_order_seq_cst);
+    Table& table = *tables_[old];
+    for (size_t s = 0; s < table.shard_count; ++s) {
+        while (table.shards[s].writers.load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+    }
+    return table;
+}
+
+DigestStatsSnapshot DigestStatsAggregator::snapshotAndReset() {
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    Table& table = switchTables();
+    DigestStatsSnapshot out = collect(table);
+    table.clear();
+    return out;
+}
+
+void DigestStatsAggregator::reset() {
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    switchTables().clear();
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,415 @@
+#include "mysql_parser_internal.h"
+#include "mysql_parser.tab.h" // Token numbers, for the digest
+#include <algorithm>
+#include <cstring>
+
+// Recognizer for the statement shapes that make up most traffic, tried by
+// ParserContext::parse() before the Flex scanner and mysql_yyparse:
+//
+//   SELECT col[, col...] FROM table [WHERE operand = operand]
+//   INSERT INTO table [(col, ...)] VALUES (operand, ...)[, (operand, ...)...]
+//   SET variable = operand[, variable = operand...]
+//   BEGIN
+//   COMMIT
+//
+// each with an optional trailing semicolon, where a column is * or a plain or
+// qualified name, and an operand is a name or a number or string literal.
+//
+// It scans the text itself and builds the tree the grammar would, node for
+// node, with the same symbols, digest, ParseLimits charges, typed statement
+// and session-state changes. It handles only the easy cases: anything else,
+// from a comment or backslash escape to an unexpected token, makes it give up
+// and the statement is parsed again from the start by the grammar.
+// examples/mysql_fast_path_benchmark.cpp checks both agree.
+
+namespace MysqlParser {
+
+namespace {
+
+// Every keyword rule in mysql_lexer.l: a word spelled like one of these is
+// that keyword, never an identifier
+struct Keyword {
+    const char* name;
+    int token;
+};
+const Keyword kKeywords[] = {
+    {"AGAINST", TOKEN_AGAINST}, {"ALL", TOKEN_ALL}, {"AND", TOKEN_AND}, {"AS", TOKEN_AS}, {"ASC", TOKEN_ASC},
+    {"AVG", TOKEN_AVG}, {"BEGIN", TOKEN_BEGIN}, {"BOOLEAN", TOKEN_BOOLEAN}, {"BY", TOKEN_BY},
+    {"CHARACTER", TOKEN_CHARACTER}, {"COLLATE", TOKEN_COLLATE}, {"COMMIT", TOKEN_COMMIT},
+    {"COMMITTED", TOKEN_COMMITTED}, {"COUNT", TOKEN_COUNT}, {"CROSS", TOKEN_CROSS},
+    {"DATABASES", TOKEN_DATABASES}, {"DEFAULT", TOKEN_DEFAULT}, {"DELETE", TOKEN_DELETE}, {"DESC", TOKEN_DESC},
+    {"DISTINCT", TOKEN_DISTINCT}, {"DUMPFILE", TOKEN_DUMPFILE}, {"ENCLOSED", TOKEN_ENCLOSED},
+    {"ESCAPED", TOKEN_ESCAPED}, {"FIELDS", TOKEN_FIELDS}, {"FOR", TOKEN_FOR}, {"FROM", TOKEN_FROM},
+    {"FULL", TOKEN_FULL}, {"GLOBAL", TOKEN_GLOBAL}, {"GROUP", TOKEN_GROUP}, {"HAVING", TOKEN_HAVING},
+    {"IGNORE", TOKEN_IGNORE_SYM}, {"IN", TOKEN_IN}, {"INNER", TOKEN_INNER}, {"INSERT", TOKEN_INSERT},
+    {"INTO", TOKEN_INTO}, {"IS", TOKEN_IS}, {"ISOLATION", TOKEN_ISOLATION}, {"JOIN", TOKEN_JOIN},
+    {"LEFT", TOKEN_LEFT}, {"LEVEL", TOKEN_LEVEL}, {"LIMIT", TOKEN_LIMIT}, {"LINES", TOKEN_LINES},
+    {"LOCKED", TOKEN_LOCKED}, {"LOW_PRIORITY", TOKEN_LOW_PRIORITY}, {"MATCH", TOKEN_MATCH}, {"MAX", TOKEN_MAX},
+    {"MIN", TOKEN_MIN}, {"MODE", TOKEN_MODE}, {"NAMES", TOKEN_NAMES}, {"NATURAL", TOKEN_NATURAL},
+    {"NOT", TOKEN_NOT}, {"NOWAIT", TOKEN_NOWAIT}, {"NULL", TOKEN_NULL_KEYWORD}, {"OF", TOKEN_OF},
+    {"OFFSET", TOKEN_OFFSET}, {"ON", TOKEN_ON}, {"OPTIONALLY", TOKEN_OPTIONALLY}, {"ORDER", TOKEN_ORDER},
+    {"OUTER", TOKEN_OUTER}, {"OUTFILE", TOKEN_OUTFILE}, {"PERSIST", TOKEN_PERSIST},
+    {"PERSIST_ONLY", TOKEN_PERSIST_ONLY}, {"QUICK", TOKEN_QUICK}, {"QUIT", TOKEN_QUIT}, {"READ", TOKEN_READ},
+    {"REPEATABLE", TOKEN_REPEATABLE}, {"RIGHT", TOKEN_RIGHT}, {"SELECT", TOKEN_SELECT},
+    {"SERIALIZABLE", TOKEN_SERIALIZABLE}, {"SESSION", TOKEN_SESSION}, {"SET", TOKEN_SET}, {"SHARE", TOKEN_SHARE},
+    {"SHOW", TOKEN_SHOW}, {"SKIP", TOKEN_SKIP}, {"STARTING", TOKEN_STARTING}, {"SUM", TOKEN_SUM},
+    {"TERMINATED", TOKEN_TERMINATED}, {"TRANSACTION", TOKEN_TRANSACTION}, {"UNCOMMITTED", TOKEN_UNCOMMITTED},
+    {"UPDATE", TOKEN_UPDATE}, {"USING", TOKEN_USING}, {"VALUES", TOKEN_VALUES}, {"WHERE", TOKEN_WHERE},
+    {"WRITE", TOKEN_WRITE}
+};
+constexpr size_t kMaxKeywordLength = 12; // PERSIST_ONLY, LOW_PRIORITY, SERIALIZABLE
+
+constexpr int kEnd = 0;          // End of input, as Flex reports it
+constexpr int kUnsupported = -1; // Anything left to the grammar
+
+inline bool is_ident_start(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+inline bool is_ident_char(char c) {
+    return is_ident_start(c) || is_digit(c);
+}
+
+// Token of the keyword spelled by word in any case, else TOKEN_IDENTIFIER
+int classify_word(const char* word, size_t len) {
+    if (len > kMaxKeywordLength) return TOKEN_IDENTIFIER;
+    char upper[kMaxKeywordLength + 1];
+    for (size_t i = 0; i < len; ++i) {
+        char c = word[i];
+        upper[i] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+    upper[len] = '\0';
+    const Keyword* end = kKeywords + sizeof(kKeywords) / sizeof(kKeywords[0]);
+    const Keyword* it = std::lower_bound(kKeywords, end, upper,
+                                         [](const Keyword& k, const char* w) { return std::strcmp(k.name, w) < 0; });
+    return (it != end && std::strcmp(it->name, upper) == 0) ? it->token : TOKEN_IDENTIFIER;
+}
+
+class FastParser {
+public:
+    FastParser(ParserContext& ctx, const char* sql, size_t len) : ctx_(ctx), pos_(sql), end_(sql + len) {}
+
+    bool parse() {
+        advance();
+        switch (token_) {
+            case TOKEN_SELECT: return select_statement();
+            case TOKEN_INSERT: return insert_statement();
+            case TOKEN_SET: return set_statement();
+            case TOKEN_BEGIN: return keyword_statement(NodeType::NODE_BEGIN_STATEMENT, "BEGIN");
+            case TOKEN_COMMIT: return keyword_statement(NodeType::NODE_COMMIT_STATEMENT, "COMMIT");
+            default: return false;
+        }
+    }
+
+private:
+    // --- Scanner, one token of lookahead: token_, with its text in text_ ---
+
+    // Reads the next token with the bookkeeping mysql_yylex does around Flex
+    void advance() {
+        if (!ctx_.internal_charge_token()) {
+            token_ = kUnsupported;
+            return;
+        }
+        token_ = scan();
+        if (token_ == TOKEN_LPAREN) {
+            ctx_.internal_enter_paren();
+        } else if (token_ == TOKEN_RPAREN) {
+            ctx_.internal_leave_paren();
+        }
+        if (token_ != kUnsupported) ctx_.internal_digest_token(token_, token_ == TOKEN_IDENTIFIER ? &text_ : nullptr);
+    }
+
+    int scan() {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r')) ++pos_;
+        if (pos_ == end_) return kEnd;
+        const char* start = pos_;
+        char c = *pos_++;
+        if (is_ident_start(c)) {
+            while (pos_ < end_ && is_ident_char(*pos_)) ++pos_;
+            // A UTF-8 identifier, or an X'..' hex literal
+            if (pos_ < end_ && (static_cast<unsigned char>(*pos_) >= 0x80 ||
+                                (*pos_ == '\'' && pos_ - start == 1 && (c == 'x' || c == 'X')))) {
+                return kUnsupported;
+            }
+            int token = classify_word(start, pos_ - start);
+            if (token == TOKEN_IDENTIFIER) text_.assign(start, pos_ - start);
+            return token;
+        }
+        if (is_digit(c)) {
+            while (pos_ < end_ && is_digit(*pos_)) ++pos_;
+            if (end_ - pos_ > 1 && *pos_ == '.' && is_digit(pos_[1])) {
+                for (pos_ += 2; pos_ < end_ && is_digit(*pos_);) ++pos_;
+            }
+            // Exponents, hex literals and digits running into a name
+            if (pos_ < end_ && (is_ident_char(*pos_) || *pos_ == '.' || static_cast<unsigned char>(*pos_) >= 0x80)) {
+                return kUnsupported;
+            }
+            text_.assign(start, pos_ - start);
+            return TOKEN_NUMBER_LITERAL;
+        }
+        switch (c) {
+            case '\'':
+            case '"': return scan_quoted(c);
+            case '`': return scan_backticked();
+            case ',': return TOKEN_COMMA;
+            case '(': return TOKEN_LPAREN;
+            case ')': return TOKEN_RPAREN;
+            case ';': return TOKEN_SEMICOLON;
+            case '.': return TOKEN_DOT;
+            case '*': return TOKEN_ASTERISK;
+            case '=': return TOKEN_EQUAL;
+            default: return kUnsupported; // Other operators, comments, variables
+        }
+    }
+
+    // A string literal after its opening quote. Only doubled quotes are
+    // unescaped here; a backslash escape is left to the lexer.
+    int scan_quoted(char quote) {
+        text_.clear();
+        escaped_ = false;
+        const char* run = pos_;
+        for (; pos_ < end_; ++pos_) {
+            if (*pos_ == '\\') return kUnsupported;
+            if (*pos_ != quote) continue;
+            text_.append(run, pos_ - run);
+            if (end_ - pos_ > 1 && pos_[1] == quote) {
+                text_ += quote;
+                escaped_ = true;
+                run = ++pos_ + 1;
+                continue;
+            }
+            ++pos_;
+            return TOKEN_STRING_LITERAL;
+        }
+        return kUnsupported; // Unterminated
+    }
+
+    int scan_backticked() {
+        text_.clear();
+        const char* run = pos_;
+        for (; pos_ < end_; ++pos_) {
+            if (*pos_ == '\n') return kUnsupported;
+            if (*pos_ != '`') continue;
+            text_.append(run, pos_ - run);
+            if (end_ - pos_ > 1 && pos_[1] == '`') {
+                text_ += '`';
+                run = ++pos_ + 1;
+                continue;
+            }
+            ++pos_;
+            return TOKEN_IDENTIFIER;
+        }
+        return kUnsupported; // Unterminated
+    }
+
+    // --- Recognizer: each rule builds what the matching grammar action does ---
+
+    AstNode* make(NodeType type, std::string&& value = std::string()) {
+        ctx_.internal_charge_node();
+        return new AstNode(type, std::move(value));
+    }
+
+    // identifier_node
+    std::unique_ptr<AstNode> identifier() {
+        std::unique_ptr<AstNode> id(make(NodeType::NODE_IDENTIFIER, std::move(text_)));
+        id->symbol = ctx_.internal_intern(id->value);
+        advance();
+        return id;
+    }
+
+    // table_name_spec, and the names among simple_expression
+    std::unique_ptr<AstNode> name() {
+        if (token_ != TOKEN_IDENTIFIER) return nullptr;
+        std::unique_ptr<AstNode> first = identifier();
+        if (token_ != TOKEN_DOT) return first;
+        advance();
+        if (token_ != TOKEN_IDENTIFIER) return nullptr; // t.* among other things
+        std::unique_ptr<AstNode> second = identifier();
+        std::unique_ptr<AstNode> qualified(make(NodeType::NODE_QUALIFIED_IDENTIFIER, first->value + "." + second->value));
+        qualified->addChild(first.release());
+        qualified->addChild(second.release());
+        return qualified;
+    }
+
+    // The simple_expression forms handled here: names and literals
+    std::unique_ptr<AstNode> operand() {
+        std::unique_ptr<AstNode> literal;
+        if (token_ == TOKEN_NUMBER_LITERAL) {
+            literal.reset(make(NodeType::NODE_NUMBER_LITERAL, std::move(text_)));
+        } else if (token_ == TOKEN_STRING_LITERAL) {
+            literal.reset(make(NodeType::NODE_STRING_LITERAL, std::move(text_))); // Charged by the lexer there
+            literal->escaped = escaped_;
+        } else {
+            return name();
+        }
+        advance();
+        return literal;
+    }
+
+    // optional_semicolon and the end of input, then the statement rule
+    bool finish(StatementKind kind, std::unique_ptr<AstNode>& root) {
+        if (token_ == TOKEN_SEMICOLON) advance();
+        if (token_ != kEnd || ctx_.status_ != ParseStatus::Ok) return false;
+        ctx_.internal_set_statement(kind, root.release());
+        return true;
+    }
+
+    bool select_statement() {
+        advance();
+        std::unique_ptr<AstNode> root(make(NodeType::NODE_SELECT_STATEMENT));
+        AstNode* items = make(NodeType::NODE_SELECT_ITEM_LIST);
+        root->addChild(items);
+        for (;;) {
+            AstNode* item = make(NodeType::NODE_SELECT_ITEM);
+            items->addChild(item);
+            if (token_ == TOKEN_ASTERISK) {
+                item->addChild(make(NodeType::NODE_ASTERISK, "*"));
+                advance();
+            } else {
+                std::unique_ptr<AstNode> expr = operand();
+                if (!expr) return false;
+                item->addChild(expr.release());
+            }
+            if (token_ != TOKEN_COMMA) break;
+            advance();
+        }
+
+        AstNode* from = nullptr;
+        if (token_ == TOKEN_FROM) {
+            advance();
+            from = make(NodeType::NODE_FROM_CLAUSE);
+            root->addChild(from);
+            AstNode* reference = make(NodeType::NODE_TABLE_REFERENCE);
+            from->addChild(reference);
+            std::unique_ptr<AstNode> table = name();
+            if (!table) return false;
+            reference->addChild(table.release());
+        }
+
+        AstNode* where = nullptr;
+        if (token_ == TOKEN_WHERE) {
+            advance();
+            where = make(NodeType::NODE_WHERE_CLAUSE);
+            root->addChild(where);
+            std::unique_ptr<AstNode> left = operand();
+            if (!left || token_ != TOKEN_EQUAL) return false;
+            advance();
+            ctx_.internal_charge_node(); // The grammar's comparison_operator node
+            AstNode* comparison = make(NodeType::NODE_COMPARISON_EXPRESSION, "=");
+            where->addChild(comparison);
+            comparison->addChild(left.release());
+            std::unique_ptr<AstNode> right = operand();
+            if (!right) return false;
+            comparison->addChild(right.release());
+        }
+
+        ctx_.statement_.select = SelectStmt{nullptr, items, nullptr, from, where};
+        return finish(StatementKind::Select, root);
+    }
+
+    bool insert_statement() {
+        advance();
+        if (token_ != TOKEN_INTO) return false;
+        advance();
+        std::unique_ptr<AstNode> root(make(NodeType::NODE_INSERT_STATEMENT));
+        std::unique_ptr<AstNode> table = name();
+        if (!table) return false;
+        AstNode* table_name = table.release();
+        root->addChild(table_name);
+
+        AstNode* columns = nullptr;
+        if (token_ == TOKEN_LPAREN) {
+            advance();
+            columns = make(NodeType::NODE_COLUMN_LIST);
+            root->addChild(columns);
+            for (;;) {
+                if (token_ != TOKEN_IDENTIFIER) return false;
+                columns->addChild(identifier().release());
+                if (token_ != TOKEN_COMMA) break;
+                advance();
+            }
+            if (token_ != TOKEN_RPAREN) return false;
+            advance();
+        }
+
+        if (token_ != TOKEN_VALUES) return false;
+        advance();
+        AstNode* values = make(NodeType::NODE_VALUES_CLAUSE);
+        root->addChild(values);
+        AstNode* rows = make(NodeType::NODE_VALUE_ROW_LIST);
+        values->addChild(rows);
+        for (;;) {
+            if (token_ != TOKEN_LPAREN) return false;
+            advance();
+            AstNode* row = make(NodeType::NODE_EXPRESSION_LIST);
+            rows->addChild(row);
+            for (;;) {
+                std::unique_ptr<AstNode> value = operand();
+                if (!value) return false;
+                row->addChild(value.release());
+                if (token_ != TOKEN_COMMA) break;
+                advance();
+            }
+            if (token_ != TOKEN_RPAREN) return false;
+            advance();
+            if (token_ != TOKEN_COMMA) break;
+            advance();
+        }
+
+        ctx_.statement_.insert = InsertStmt{table_name, columns, values};
+        return finish(StatementKind::Insert, root);
+    }
+
+    // SET of unscoped system variables only
+    bool set_statement() {
+        advance();
+        std::unique_ptr<AstNode> root(make(NodeType::NODE_SET_STATEMENT, "SET_VARIABLES"));
+        AstNode* assignments = make(NodeType::NODE_VARIABLE_ASSIGNMENT_LIST);
+        root->addChild(assignments);
+        for (;;) {
+            if (token_ != TOKEN_IDENTIFIER) return false;
+            AstNode* assignment = make(NodeType::NODE_VARIABLE_ASSIGNMENT);
+            assignments->addChild(assignment);
+            std::unique_ptr<AstNode> id = identifier();
+            AstNode* variable = make(NodeType::NODE_SYSTEM_VARIABLE, std::move(id->value)); // RENAME_IDENTIFIER
+            variable->symbol = id->symbol;
+            assignment->addChild(variable);
+            if (token_ != TOKEN_EQUAL) return false;
+            advance();
+            std::unique_ptr<AstNode> value = operand();
+            if (!value) return false;
+            AstNode* value_node = value.release();
+            assignment->addChild(value_node);
+            ctx_.internal_record_assignment(variable, value_node);
+            if (token_ != TOKEN_COMMA) break;
+            advance();
+        }
+
+        ctx_.statement_.set = SetStmt{assignments, nullptr, nullptr, nullptr};
+        return finish(StatementKind::Set, root);
+    }
+
+    // BEGIN, COMMIT
+    bool keyword_statement(NodeType type, const char* keyword) {
+        std::unique_ptr<AstNode> root(make(type, keyword));
+        advance();
+        return finish(StatementKind::Other, root);
+    }
+
+    ParserContext& ctx_;
+    const char* pos_;
+    const char* end_;
+    int token_ = kEnd;
+    std::string text_;    // Identifier, number or unescaped string
+    bool escaped_ = false; // Of a string literal, as AstNode::escaped
+};
+
+} // namespace
+
+bool ParserContext::internal_fast_parse(const char* sql_query, size_t sql_len) {
+    return FastParser(*this, sql_query, sql_len).parse();
+}
+
+} // namespace MysqlParser
@@ -1,101 +1,333 @@
 #include "mysql_parser/mysql_parser.h"
+#include "mysql_parser_internal.h"
 #include <stdexcept>
+#include <climits>
+#include <cstdio>
+#include <mutex>
 
-// yyscan_t is defined as typedef void* yyscan_t; in mysql_parser.h
+// yyscan_t is defined as typedef void* yyscan_t; in mysql_parser_internal.h
 struct yy_buffer_state; // Forward declaration for the opaque Flex buffer type
 typedef struct yy_buffer_state *YY_BUFFER_STATE;
 
 // Flex utility functions are now from C++ compiled mysql_lexer.yy.c
 // No extern "C" needed for these declarations as their definitions will also have C++ linkage.
-extern int mysql_yylex_init_extra(MysqlParser::Parser* user_defined, yyscan_t* yyscanner_r);
-extern int mysql_yylex_destroy(yyscan_t yyscanner); 
-extern YY_BUFFER_STATE mysql_yy_scan_string(const char *yy_str, yyscan_t yyscanner);
+extern int mysql_yylex_init_extra(MysqlParser::ParserContext* user_defined, yyscan_t* yyscanner_r);
+extern void mysql_yyset_extra(MysqlParser::ParserContext* user_defined, yyscan_t yyscanner);
+extern int mysql_yylex_destroy(yyscan_t yyscanner);
+extern YY_BUFFER_STATE mysql_yy_scan_bytes(const char *bytes, int len, yyscan_t yyscanner);
 extern void mysql_yy_delete_buffer(YY_BUFFER_STATE b, yyscan_t yyscanner);
 
 // Bison-generated parser function (now compiled as C++, so C++ linkage)
 // The api.prefix makes it mysql_yyparse.
 // The %parse-param defines its arguments.
-extern int mysql_yyparse(yyscan_t yyscanner, MysqlParser::Parser* parser_context);
-
-// mysql_yyerror is called by mysql_yyparse.
-// Since mysql_yyparse is C++, mysql_yyerror can also be regular C++.
-// Its declaration is in mysql_parser.h (should also not be extern "C" there).
-// The definition is at the bottom of this file.
-void mysql_yyerror(yyscan_t yyscanner, MysqlParser::Parser* parser_context, const char* msg);
+extern int mysql_yyparse(yyscan_t yyscanner, MysqlParser::ParserContext* parser_context);
 
 
 namespace MysqlParser {
 
-Parser::Parser() : ast_root_(nullptr), scanner_state_(nullptr) {
-    if (mysql_yylex_init_extra(this, &scanner_state_)) {
-        throw std::runtime_error("MysqlParser: Failed to initialize Flex scanner.");
+namespace {
+
+// Pool of initialized Flex scanners shared by all Parser instances, so that
+// short-lived parsers (e.g. one per client connection) do not each pay for
+// mysql_yylex_init_extra/mysql_yylex_destroy. A scanner holds no query state
+// between parses, so any idle one can be handed to the next parser.
+const size_t kMaxPooledScanners = 256;
+
+std::mutex& scanner_pool_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<yyscan_t>& scanner_pool() {
+    static std::vector<yyscan_t>* pool = new std::vector<yyscan_t>(); // Never destroyed: parsers may outlive statics
+    return *pool;
+}
+
+yyscan_t acquire_scanner(ParserContext* owner) {
+    yyscan_t scanner = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(scanner_pool_mutex());
+        std::vector<yyscan_t>& pool = scanner_pool();
+        if (!pool.empty()) {
+            scanner = pool.back();
+            pool.pop_back();
+        }
+    }
+    if (scanner) {
+        mysql_yyset_extra(owner, scanner);
+    } else if (mysql_yylex_init_extra(owner, &scanner)) {
+        return nullptr;
+    }
+    return scanner;
+}
+
+void release_scanner(yyscan_t scanner) {
+    mysql_yyset_extra(nullptr, scanner);
+    {
+        std::lock_guard<std::mutex> lock(scanner_pool_mutex());
+        std::vector<yyscan_t>& pool = scanner_pool();
+        if (pool.size() < kMaxPooledScanners) {
+            pool.push_back(scanner);
+            return;
+        }
     }
+    mysql_yylex_destroy(scanner);
 }
 
-Parser::~Parser() {
+} // namespace
+
+ParserContext::~ParserContext() {
     if (scanner_state_) {
-        mysql_yylex_destroy(scanner_state_);
+        release_scanner(scanner_state_);
     }
 }
 
-void Parser::clearErrors() {
+void ParserContext::reset_parse_state() {
     errors_.clear();
+    ast_root_.reset();
+    statement_ = Statement();
+    pending_session_changes_.clear();
+    comments_.clear();
+    invalid_utf8_end_ = SIZE_MAX;
+    digest_ = kDigestSeed;
+    digest_literals_ = 0;
+    status_ = ParseStatus::Ok;
+    token_count_ = 0;
+    node_count_ = 0;
+    depth_ = 0;
 }
 
-const std::vector<std::string>& Parser::getErrors() const {
-    return errors_;
+void ParserContext::apply_session_changes() {
+    if (!session_state_) return;
+    for (PendingSessionChange& change : pending_session_changes_) {
+        if (change.reset) {
+            session_state_->erase(change.variable.scope, change.variable.id);
+        } else {
+            session_state_->set(change.variable.scope, change.variable.id, std::move(change.variable.value));
+        }
+    }
 }
 
-std::unique_ptr<AstNode> Parser::parse(const std::string& sql_query) {
-    clearErrors();
-    ast_root_.reset(); 
+bool ParserContext::ensure_scanner() {
+    if (!scanner_state_) scanner_state_ = acquire_scanner(this);
+    return scanner_state_ != nullptr;
+}
+
+std::unique_ptr<AstNode> ParserContext::parse(const char* sql_query, size_t sql_len, const ParseLimits* limits) {
+    MYSQL_TRACE2(parse_start, sql_query, sql_len);
+    std::unique_ptr<AstNode> tree = run_parse(sql_query, sql_len, limits);
+    if (!tree && status_ != ParseStatus::Ok) {
+        MYSQL_TRACE2(parse_error, static_cast<int>(status_), errors_.empty() ? "" : errors_.back().c_str());
+    }
+    MYSQL_TRACE2(parse_done, static_cast<int>(status_), tree ? 1 : 0);
+    return tree;
+}
+
+std::unique_ptr<AstNode> ParserContext::run_parse(const char* sql_query, size_t sql_len, const ParseLimits* limits) {
+    reset_parse_state();
+    limits_active_ = limits != nullptr;
+    if (limits) {
+        limits_ = *limits;
+        if (limits_.time_check_interval == 0) limits_.time_check_interval = 1;
+        if (limits_.max_time_us) {
+            deadline_ = std::chrono::steady_clock::now() + std::chrono::microseconds(limits_.max_time_us);
+        }
+    }
+
+    if (!ensure_scanner()) {
+        status_ = ParseStatus::ScannerError;
+        errors_.push_back("MysqlParser: Failed to initialize Flex scanner.");
+        return nullptr;
+    }
 
-    if (!scanner_state_) {
-        errors_.push_back("MysqlParser: Scanner not initialized.");
+    if (limits && limits->max_bytes && sql_len > limits->max_bytes) {
+        status_ = ParseStatus::BytesExceeded;
+        errors_.push_back("MysqlParser: Query of " + std::to_string(sql_len) + " bytes exceeds max_bytes (" +
+                          std::to_string(limits->max_bytes) + ").");
+        return nullptr;
+    }
+    if (sql_len > static_cast<size_t>(INT_MAX) - 2) {
+        status_ = ParseStatus::BytesExceeded;
+        errors_.push_back("MysqlParser: Query too large.");
         return nullptr;
     }
 
-    YY_BUFFER_STATE buffer_state = mysql_yy_scan_string(sql_query.c_str(), scanner_state_);
+    if (replay_) {
+        // The tokens were lexed by a TokenBuffer; the scanner is not used
+        int parse_result = mysql_yyparse(scanner_state_, this);
+        MYSQL_TRACE1(grammar_done, parse_result);
+        return finish_parse(parse_result);
+    }
+
+    if (fast_path_) {
+        MYSQL_TRACE(fast_path_start);
+        bool hit = internal_fast_parse(sql_query, sql_len);
+        MYSQL_TRACE1(fast_path_done, hit ? 1 : 0);
+        if (hit) {
+            apply_session_changes();
+            return std::move(ast_root_);
+        }
+        reset_parse_state(); // Start over with the grammar; the deadline still runs from the first attempt
+    }
+
+    MYSQL_TRACE(buffer_setup_start);
+    YY_BUFFER_STATE buffer_state = mysql_yy_scan_bytes(sql_query, static_cast<int>(sql_len), scanner_state_);
+    MYSQL_TRACE(buffer_setup_done);
     if (!buffer_state) {
+        status_ = ParseStatus::ScannerError;
         errors_.push_back("MysqlParser: Error setting up scanner buffer for query.");
         return nullptr;
     }
 
     // Call mysql_yyparse (which is now a C++ function from the C++ compiled .tab.c)
     int parse_result = mysql_yyparse(scanner_state_, this);
+    MYSQL_TRACE1(grammar_done, parse_result);
 
     mysql_yy_delete_buffer(buffer_state, scanner_state_);
+    MYSQL_TRACE(buffer_teardown_done);
+    return finish_parse(parse_result);
+}
+
+std::unique_ptr<AstNode> ParserContext::finish_parse(int parse_result) {
+    if (parse_result == 0 && status_ == ParseStatus::Ok) {
+        apply_session_changes();
+        return std::move(ast_root_);
+    }
 
-    if (parse_result == 0) { 
-        return std::move(ast_root_); 
+    ast_root_.reset(); // A statement reduced before the failure
+    statement_ = Statement();
+    switch (status_) {
+        case ParseStatus::TokensExceeded:
+            errors_.push_back("MysqlParser: Query exceeds max_tokens (" + std::to_string(limits_.max_tokens) + ").");
+            break;
+        case ParseStatus::NodesExceeded:
+            errors_.push_back("MysqlParser: Query exceeds max_nodes (" + std::to_string(limits_.max_nodes) + ").");
+            break;
+        case ParseStatus::DepthExceeded:
+            errors_.push_back("MysqlParser: Query exceeds max_depth (" + std::to_string(limits_.max_depth) + ").");
+            break;
+        case ParseStatus::DeadlineExceeded:
+            errors_.push_back("MysqlParser: Parse exceeded max_time_us (" + std::to_string(limits_.max_time_us) + ").");
+            break;
+        default:
+            status_ = ParseStatus::SyntaxError;
+            break;
     }
     return nullptr;
 }
 
-void Parser::internal_set_ast(AstNode* root) {
+uint64_t ParserContext::internal_digest() const {
+    if (digest_ == kDigestSeed) return 0; // No tokens
+    uint64_t x = digest_; // splitmix64 finalizer, so every bit depends on every token
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x ? x : 1;
+}
+
+void ParserContext::internal_set_ast(AstNode* root) {
     ast_root_.reset(root);
 }
 
-void Parser::internal_add_error(const std::string& msg) {
+void ParserContext::internal_add_error(const std::string& msg) {
     errors_.push_back(msg);
 }
 
-void Parser::internal_add_error_at(const std::string& msg, int line, int column) {
+void ParserContext::internal_add_error_at(const std::string& msg, int line, int column) {
     errors_.push_back("Line " + std::to_string(line) + ", Col " + std::to_string(column) + ": " + msg);
 }
 
+
+Parser::Parser() : context_(new ParserContext()) {}
+
+Parser::~Parser() = default;
+
+Parser::Parser(Parser&& other) noexcept = default;
+
+Parser& Parser::operator=(Parser&& other) noexcept = default;
+
+void Parser::clearErrors() {
+    context_->errors_.clear();
+}
+
+const std::vector<std::string>& Parser::getErrors() const {
+    return context_->errors_;
+}
+
+void Parser::setSessionState(SessionState* state) {
+    context_->session_state_ = state;
+}
+
+void Parser::setFastPath(bool enabled) {
+    context_->fast_path_ = enabled;
+}
+
+void Parser::setSymbolTable(SymbolTable* symbols) {
+    if (symbols && !context_->symbol_cache_) {
+        context_->symbol_cache_.reset(new ParserContext::SymbolCacheEntry[ParserContext::kSymbolCacheSize]);
+    }
+    if (context_->symbol_cache_) {
+        for (size_t i = 0; i < ParserContext::kSymbolCacheSize; ++i) context_->symbol_cache_[i] = {0, kNoSymbol};
+    }
+    context_->symbols_ = symbols;
+}
+
+std::unique_ptr<AstNode> Parser::parse(const std::string& sql_query) {
+    return context_->parse(sql_query.data(), sql_query.size());
+}
+
+std::unique_ptr<AstNode> Parser::parse(const char* sql_query, size_t sql_len) {
+    return context_->parse(sql_query, sql_len);
+}
+
+std::unique_ptr<AstNode> Parser::parse(const std::string& sql_query, const ParseLimits& limits) {
+    return context_->parse(sql_query.data(), sql_query.size(), &limits);
+}
+
+std::unique_ptr<AstNode> Parser::parse(const char* sql_query, size_t sql_len, const ParseLimits& limits) {
+    return context_->parse(sql_query, sql_len, &limits);
+}
+
+std::unique_ptr<AstNode> Parser::parse(const TokenBuffer& tokens) {
+    return context_->parse(tokens, nullptr);
+}
+
+std::unique_ptr<AstNode> Parser::parse(const TokenBuffer& tokens, const ParseLimits& limits) {
+    return context_->parse(tokens, &limits);
+}
+
+ParseStatus Parser::getStatus() const {
+    return context_->status_;
+}
+
+const QueryComments& Parser::getComments() const {
+    return context_->comments_;
+}
+
+const Statement& Parser::getStatement() const {
+    return context_->statement_;
+}
+
+uint64_t Parser::getDigest() const {
+    return context_->internal_digest();
+}
+
 } // namespace MysqlParser
 
 
 // This function is called by Bison-generated code (mysql_yyparse).
 // Since mysql_yyparse is now compiled as C++, this can be a regular C++ function.
 // The name must match what Bison expects (mysql_yyerror).
-// Its declaration is in mysql_parser.h and should also not be extern "C".
-void mysql_yyerror(yyscan_t yyscanner, MysqlParser::Parser* parser_context, const char* msg) {
+// Its declaration is in mysql_parser_internal.h and should also not be extern "C".
+void mysql_yyerror(yyscan_t yyscanner, MysqlParser::ParserContext* parser_context, const char* msg) {
+    if (parser_context && parser_context->internal_limit_exceeded()) {
+        return; // The "unexpected TOKEN_LIMIT_EXCEEDED" error; parse() reports the limit instead
+    }
     if (parser_context) {
         parser_context->internal_add_error(msg);
     } else {
         fprintf(stderr, "MysqlParser Error (yyerror - no context): %s\n", msg);
     }
 }
-
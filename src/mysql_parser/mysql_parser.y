@@ -1,16 +1,32 @@
 %code requires {
     namespace MysqlParser {
       struct AstNode;
+      class ParserContext;
     }
+    typedef void* yyscan_t;
     #include <string>
 }
 
 %{
-#include "mysql_parser/mysql_parser.h"
+#include "mysql_parser_internal.h"
 #include "mysql_parser/mysql_ast.h"
 
 union MYSQL_YYSTYPE;
-int mysql_yylex(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlParser::Parser* parser_context);
+int mysql_yylex(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlParser::ParserContext* parser_context);
+int mysql_yylex_raw(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlParser::ParserContext* parser_context); // Flex scanner
+
+// Every node the grammar creates is charged to the parse's ParseLimits::max_nodes budget
+#define NEW_AST_NODE(...) (parser_context->internal_charge_node(), new MysqlParser::AstNode(__VA_ARGS__))
+
+// A node of another type named by identifier node id, which is consumed: its
+// text is moved rather than copied, and its symbol carried over
+static MysqlParser::AstNode* rename_identifier(MysqlParser::ParserContext* parser_context, MysqlParser::NodeType type, MysqlParser::AstNode* id) {
+    MysqlParser::AstNode* node = NEW_AST_NODE(type, std::move(id->value));
+    node->symbol = id->symbol;
+    delete id;
+    return node;
+}
+#define RENAME_IDENTIFIER(type, id) rename_identifier(parser_context, type, id)
 %}
 
 %define api.prefix {mysql_yy}
@@ -18,10 +34,10 @@ int mysql_yylex(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlPars
 %define parse.error verbose
 
 %lex-param { yyscan_t yyscanner }
-%lex-param { MysqlParser::Parser* parser_context }
+%lex-param { MysqlParser::ParserContext* parser_context }
 
 %parse-param { yyscan_t yyscanner }
-%parse-param { MysqlParser::Parser* parser_context }
+%parse-param { MysqlParser::ParserContext* parser_context }
 
 %union {
     std::string* str_val;
@@ -58,22 +74,23 @@ int mysql_yylex(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlPars
 
 %token TOKEN_MATCH TOKEN_AGAINST TOKEN_BOOLEAN TOKEN_MODE
 
-%token TOKEN_IN // For IN BOOLEAN MODE, and potentially IN operator later
+%token TOKEN_IN // IN (list) predicates and IN BOOLEAN MODE
 %token TOKEN_SHOW TOKEN_DATABASES /* Added for SHOW DATABASES */
 /* TOKEN_FIELDS is already declared */
 /* TOKEN_FULL is already declared */
 %token TOKEN_BEGIN TOKEN_COMMIT /* Added for BEGIN/COMMIT */
 %token TOKEN_IS TOKEN_NULL_KEYWORD TOKEN_NOT /* Added for IS NULL / IS NOT NULL */
 %token TOKEN_OFFSET /* Added for LIMIT ... OFFSET ... */
+%token TOKEN_LIMIT_EXCEEDED /* Returned by mysql_yylex once a ParseLimits budget is spent; no rule accepts it */
 
 %token <str_val> TOKEN_QUIT
 %token <str_val> TOKEN_IDENTIFIER
-%token <str_val> TOKEN_STRING_LITERAL
+%token <node_val> TOKEN_STRING_LITERAL
 %token <str_val> TOKEN_NUMBER_LITERAL
 
 // Types
 %type <node_val> statement simple_statement command_statement select_statement insert_statement delete_statement
-%type <node_val> identifier_node string_literal_node number_literal_node value_for_insert optional_semicolon show_statement begin_statement commit_statement
+%type <node_val> identifier_node string_literal_node number_literal_node value_for_insert show_statement begin_statement commit_statement
 %type <node_val> set_statement set_option_list set_option set_transaction_statement transaction_characteristic_list transaction_characteristic isolation_level_spec
 %type <node_val> variable_to_set user_variable system_variable_unqualified system_variable_qualified
 %type <node_val> variable_scope
@@ -102,7 +119,7 @@ int mysql_yylex(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlPars
 %type <node_val> opt_into_outfile_options_list opt_into_outfile_options_list_tail into_outfile_options_list into_outfile_option
 %type <node_val> fields_options_clause lines_options_clause field_option_outfile_list field_option_outfile line_option_outfile_list line_option_outfile
 %type <node_val> opt_locking_clause_list locking_clause_list locking_clause lock_strength opt_lock_table_list opt_lock_option
-%type <node_val> show_what show_full_modifier show_from_or_in
+%type <node_val> show_what show_full_modifier
 
 
 %type <node_val> subquery derived_table
@@ -113,12 +130,17 @@ int mysql_yylex(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlPars
 %type <node_val> opt_column_list column_list_item_list column_list_item
 %type <node_val> values_clause value_row_list value_row expression_list
 
+// Free the values of symbols discarded when a parse fails (syntax error or
+// exhausted ParseLimits). The statement node is already owned by ParserContext.
+%destructor { delete $$; } <node_val> <str_val>
+%destructor { } statement single_input_statement
+
 // Precedence
 %left TOKEN_OR
 %left TOKEN_AND
 %right TOKEN_NOT // For logical NOT
 
-%left TOKEN_EQUAL TOKEN_LESS TOKEN_GREATER TOKEN_LESS_EQUAL TOKEN_GREATER_EQUAL TOKEN_NOT_EQUAL TOKEN_IS // Added TOKEN_IS
+%left TOKEN_EQUAL TOKEN_LESS TOKEN_GREATER TOKEN_LESS_EQUAL TOKEN_GREATER_EQUAL TOKEN_NOT_EQUAL TOKEN_IS TOKEN_IN // Added TOKEN_IS, TOKEN_IN
 
 %left TOKEN_PLUS TOKEN_MINUS
 %left TOKEN_ASTERISK TOKEN_DIVIDE
@@ -171,14 +193,14 @@ query_list:
 */
 
 statement:
-    simple_statement    { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
-    | select_statement  { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
-    | insert_statement  { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
-    | set_statement     { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
-    | delete_statement  { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
-    | show_statement    { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
-    | begin_statement   { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
-    | commit_statement  { $$ = $1; if (parser_context) parser_context->internal_set_ast($1); }
+    simple_statement    { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Other, $1); }
+    | select_statement  { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Select, $1); }
+    | insert_statement  { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Insert, $1); }
+    | set_statement     { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Set, $1); }
+    | delete_statement  { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Delete, $1); }
+    | show_statement    { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Other, $1); }
+    | begin_statement   { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Other, $1); }
+    | commit_statement  { $$ = $1; if (parser_context) parser_context->internal_set_statement(MysqlParser::StatementKind::Other, $1); }
     ;
 
 simple_statement:
@@ -187,31 +209,22 @@ simple_statement:
 
 command_statement:
     TOKEN_QUIT optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_COMMAND, std::move(*$1));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_COMMAND, std::move(*$1));
         delete $1;
     }
     ;
 
-optional_semicolon:
-    TOKEN_SEMICOLON { $$ = nullptr; }
-    | /* empty */   { $$ = nullptr; }
+optional_semicolon: // Untyped: carries no value
+    TOKEN_SEMICOLON { }
+    | /* empty */   { }
     ;
 
 identifier_node:
     TOKEN_IDENTIFIER {
-        std::string val = std::move(*$1);
+        // Backticked identifiers arrive already unquoted from the lexer
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_IDENTIFIER, std::move(*$1));
+        $$->symbol = parser_context->internal_intern($$->value);
         delete $1;
-        // Unquoting logic for backticked identifiers
-        if (val.length() >= 2 && val.front() == '`' && val.back() == '`') {
-            val = val.substr(1, val.length() - 2);
-            // Replace `` with `
-            size_t pos = 0;
-            while ((pos = val.find("``", pos)) != std::string::npos) {
-                val.replace(pos, 2, "`");
-                pos += 1; // Move past the replaced `
-            }
-        }
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_IDENTIFIER, std::move(val));
     }
     ;
 
@@ -219,7 +232,7 @@ qualified_identifier_node: // For table.column or schema.table
     identifier_node TOKEN_DOT identifier_node {
         std::string qualified_name = $1->value + "." + $3->value;
         // Create a generic node; specific handling might be needed based on context
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_QUALIFIED_IDENTIFIER, std::move(qualified_name));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_QUALIFIED_IDENTIFIER, std::move(qualified_name));
         $$->addChild($1); // table/schema
         $$->addChild($3); // column/table
     }
@@ -228,71 +241,14 @@ qualified_identifier_node: // For table.column or schema.table
 
 string_literal_node:
     TOKEN_STRING_LITERAL {
-        std::string raw_val = std::move(*$1);
-        delete $1;
-        std::string val_content;
-        char quote_char = 0;
-        if (!raw_val.empty()) quote_char = raw_val.front();
-
-        if (raw_val.length() >= 2 && (raw_val.front() == '\'' || raw_val.front() == '"') && raw_val.front() == raw_val.back()) {
-            val_content = raw_val.substr(1, raw_val.length() - 2);
-        } else {
-            // This case might occur if the lexer returns unquoted strings for some reason,
-            // or for types like hex literals X'...' that might not be strictly string literals
-            // but are passed as TOKEN_STRING_LITERAL.
-            val_content = raw_val;
-        }
-
-        std::string unescaped_val;
-        unescaped_val.reserve(val_content.length());
-        bool escaping = false;
-        for (size_t i = 0; i < val_content.length(); ++i) {
-            if (escaping) {
-                switch (val_content[i]) {
-                    case 'n': unescaped_val += '\n'; break;
-                    case 't': unescaped_val += '\t'; break;
-                    case 'r': unescaped_val += '\r'; break;
-                    case 'b': unescaped_val += '\b'; break;
-                    case '0': unescaped_val += '\0'; break; // Null character
-                    case 'Z': unescaped_val += '\x1A'; break; // Ctrl+Z for SUB
-                    case '\\': unescaped_val += '\\'; break;
-                    case '\'': unescaped_val += '\''; break;
-                    case '"': unescaped_val += '"'; break;
-                    // MySQL also allows escaping % and _ for LIKE contexts, but that's usually handled by the expression evaluation, not lexing/parsing of the literal itself.
-                    default:
-                        // If the character after \ is not a special escape char, MySQL treats \ as a literal \
-                        // However, standard SQL behavior is often to just take the character literally.
-                        // For simplicity here, let's assume it might be an escaped char that we just pass through,
-                        // or a literal backslash followed by a character.
-                        // A more robust parser might differentiate or follow strict SQL standard for unknown escapes.
-                        // For now, we'll treat it as literal character following backslash if not recognized.
-                        unescaped_val += val_content[i]; // Or just `unescaped_val += '\\'; unescaped_val += val_content[i];` if \ is always literal
-                        break;
-                }
-                escaping = false;
-            } else if (val_content[i] == '\\') {
-                // Check if it's a MySQL specific escape sequence that the lexer didn't handle
-                // (e.g., if lexer is very basic and passes \ through).
-                // Standard SQL string literals use '' for ' and "" for ".
-                // MySQL also uses \', \", \\.
-                escaping = true;
-            } else if (quote_char != 0 && val_content[i] == quote_char && (i + 1 < val_content.length() && val_content[i+1] == quote_char) ) { // Handle '' or "" for literal quote (SQL Standard)
-                unescaped_val += quote_char;
-                i++; // Skip the second quote
-            }
-            else {
-                unescaped_val += val_content[i];
-            }
-        }
-        if(escaping) unescaped_val+='\\'; // if string ends with a single backslash
-
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_STRING_LITERAL, std::move(unescaped_val));
+        // The lexer builds the NODE_STRING_LITERAL itself, already unquoted and unescaped
+        $$ = $1;
     }
     ;
 
 number_literal_node:
     TOKEN_NUMBER_LITERAL {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_NUMBER_LITERAL, std::move(*$1));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_NUMBER_LITERAL, std::move(*$1));
         delete $1;
     }
     ;
@@ -309,45 +265,48 @@ select_statement:
                  opt_limit_clause
                  opt_locking_clause_list
                  optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SELECT_STATEMENT);
-        if ($2) $$->addChild($2); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SELECT_OPTIONS)); // Ensure options node exists
-        $$->addChild($3); // select_item_list
-        if ($4) $$->addChild($4); // opt_into_clause
-        if ($5) $$->addChild($5); // opt_from_clause
-        if ($6) $$->addChild($6); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_WHERE_CLAUSE));
-        if ($7) $$->addChild($7); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_GROUP_BY_CLAUSE));
-        if ($8) $$->addChild($8); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_HAVING_CLAUSE));
-        if ($9) $$->addChild($9); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ORDER_BY_CLAUSE));
-        if ($10) $$->addChild($10); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LIMIT_CLAUSE));
-        if ($11) $$->addChild($11); // opt_locking_clause_list
+        // Absent clauses get no placeholder node; see mysql_statement.h
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SELECT_STATEMENT);
+        $$->children.reserve(11);
+        $$->addChild($2);  // opt_select_options
+        $$->addChild($3);  // select_item_list
+        $$->addChild($4);  // opt_into_clause
+        $$->addChild($5);  // opt_from_clause
+        $$->addChild($6);  // opt_where_clause
+        $$->addChild($7);  // opt_group_by_clause
+        $$->addChild($8);  // opt_having_clause
+        $$->addChild($9);  // opt_order_by_clause
+        $$->addChild($10); // opt_limit_clause
+        $$->addChild($11); // opt_locking_clause_list
+        // A subquery's select is reduced before the statement containing it,
+        // so the top-level statement's clauses are the ones left here
+        parser_context->statement_.select = MysqlParser::SelectStmt{$2, $3, $4, $5, $6, $7, $8, $9, $10, $11};
     }
     ;
 
 opt_alias:
     /* empty */ { $$ = nullptr; }
     | TOKEN_AS identifier_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ALIAS, $2->value);
-        delete $2;
+        $$ = RENAME_IDENTIFIER(MysqlParser::NodeType::NODE_ALIAS, $2);
     }
     | identifier_node { // Implicit AS
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ALIAS, $1->value);
-        delete $1;
+        $$ = RENAME_IDENTIFIER(MysqlParser::NodeType::NODE_ALIAS, $1);
     }
     ;
 
 select_item:
     identifier_node TOKEN_DOT TOKEN_ASTERISK { // table.*
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SELECT_ITEM);
-        MysqlParser::AstNode* table_asterisk = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ASTERISK, $1->value + ".*");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SELECT_ITEM);
+        MysqlParser::AstNode* table_asterisk = NEW_AST_NODE(MysqlParser::NodeType::NODE_ASTERISK, $1->value + ".*");
         table_asterisk->addChild($1); // Store the table identifier
         $$->addChild(table_asterisk);
     }
     | TOKEN_ASTERISK { // *
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SELECT_ITEM);
-        $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ASTERISK, "*"));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SELECT_ITEM);
+        $$->addChild(NEW_AST_NODE(MysqlParser::NodeType::NODE_ASTERISK, "*"));
     }
     | expression_placeholder opt_alias {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SELECT_ITEM);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SELECT_ITEM);
         $$->addChild($1);
         if ($2) {
             $$->addChild($2);
@@ -357,7 +316,7 @@ select_item:
 
 select_item_list:
     select_item {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SELECT_ITEM_LIST);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SELECT_ITEM_LIST);
         $$->addChild($1);
     }
     | select_item_list TOKEN_COMMA select_item {
@@ -367,8 +326,8 @@ select_item_list:
     ;
 
 select_option_item:
-    TOKEN_DISTINCT { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "DISTINCT"); }
-    | TOKEN_ALL { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "ALL"); }
+    TOKEN_DISTINCT { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "DISTINCT"); }
+    | TOKEN_ALL { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "ALL"); }
     // Add other select options like SQL_CALC_FOUND_ROWS if needed
     ;
 
@@ -377,7 +336,7 @@ opt_select_options:
     | select_option_item opt_select_options { // Allows multiple options like ALL DISTINCT (though not valid SQL, grammar might allow)
         MysqlParser::AstNode* options_node;
         if ($2 == nullptr) { // First option in the list
-            options_node = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SELECT_OPTIONS);
+            options_node = NEW_AST_NODE(MysqlParser::NodeType::NODE_SELECT_OPTIONS);
             options_node->addChild($1);
         } else { // Subsequent options
             options_node = $2;
@@ -401,23 +360,23 @@ opt_into_clause:
 
 into_clause:
     TOKEN_INTO TOKEN_OUTFILE string_literal_node opt_into_outfile_options_list {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_INTO_OUTFILE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_INTO_OUTFILE);
         $$->addChild($3); // string_literal_node for filename
         if ($4) $$->addChild($4); // opt_into_outfile_options_list
     }
     | TOKEN_INTO TOKEN_DUMPFILE string_literal_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_INTO_DUMPFILE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_INTO_DUMPFILE);
         $$->addChild($3); // string_literal_node for filename
     }
     | TOKEN_INTO user_var_list {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_INTO_VAR_LIST);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_INTO_VAR_LIST);
         $$->addChild($2); // user_var_list
     }
     ;
 
 user_var_list:
     user_variable {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_COLUMN_LIST); // Re-use for list of user variables
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_COLUMN_LIST); // Re-use for list of user variables
         $$->addChild($1);
     }
     | user_var_list TOKEN_COMMA user_variable {
@@ -429,8 +388,8 @@ user_var_list:
 opt_into_outfile_options_list:
     /* empty */ { $$ = nullptr; }
     | TOKEN_CHARACTER TOKEN_SET charset_name_or_default opt_into_outfile_options_list_tail {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FILE_OPTIONS);
-        MysqlParser::AstNode* charset_opt_node = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_CHARSET_OPTION);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FILE_OPTIONS);
+        MysqlParser::AstNode* charset_opt_node = NEW_AST_NODE(MysqlParser::NodeType::NODE_CHARSET_OPTION);
         charset_opt_node->addChild($3); // charset_name_or_default
         $$->addChild(charset_opt_node);
         if($4) { // opt_into_outfile_options_list_tail
@@ -451,7 +410,7 @@ opt_into_outfile_options_list_tail:
 
 into_outfile_options_list:
     into_outfile_option {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FILE_OPTIONS); // Wrapper for single/multiple options
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FILE_OPTIONS); // Wrapper for single/multiple options
         $$->addChild($1);
     }
     | into_outfile_options_list into_outfile_option {
@@ -467,14 +426,14 @@ into_outfile_option:
 
 fields_options_clause:
     TOKEN_FIELDS field_option_outfile_list {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FIELDS_OPTIONS_CLAUSE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FIELDS_OPTIONS_CLAUSE);
         $$->addChild($2); // field_option_outfile_list
     }
     ;
 
 field_option_outfile_list:
     field_option_outfile {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FILE_OPTIONS); // Re-using for list of field options
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FILE_OPTIONS); // Re-using for list of field options
         $$->addChild($1);
     }
     | field_option_outfile_list field_option_outfile {
@@ -485,33 +444,33 @@ field_option_outfile_list:
 
 field_option_outfile:
     TOKEN_TERMINATED TOKEN_BY string_literal_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FIELDS_TERMINATED_BY);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FIELDS_TERMINATED_BY);
         $$->addChild($3);
     }
     | TOKEN_OPTIONALLY TOKEN_ENCLOSED TOKEN_BY string_literal_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FIELDS_OPTIONALLY_ENCLOSED_BY);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FIELDS_OPTIONALLY_ENCLOSED_BY);
         $$->addChild($4);
     }
     | TOKEN_ENCLOSED TOKEN_BY string_literal_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FIELDS_ENCLOSED_BY);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FIELDS_ENCLOSED_BY);
         $$->addChild($3);
     }
     | TOKEN_ESCAPED TOKEN_BY string_literal_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FIELDS_ESCAPED_BY);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FIELDS_ESCAPED_BY);
         $$->addChild($3);
     }
     ;
 
 lines_options_clause:
     TOKEN_LINES line_option_outfile_list {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LINES_OPTIONS_CLAUSE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LINES_OPTIONS_CLAUSE);
         $$->addChild($2); // line_option_outfile_list
     }
     ;
 
 line_option_outfile_list:
     line_option_outfile {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FILE_OPTIONS); // Re-using for list of line options
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FILE_OPTIONS); // Re-using for list of line options
         $$->addChild($1);
     }
     | line_option_outfile_list line_option_outfile {
@@ -522,11 +481,11 @@ line_option_outfile_list:
 
 line_option_outfile:
     TOKEN_STARTING TOKEN_BY string_literal_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LINES_STARTING_BY);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LINES_STARTING_BY);
         $$->addChild($3);
     }
     | TOKEN_TERMINATED TOKEN_BY string_literal_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LINES_TERMINATED_BY);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LINES_TERMINATED_BY);
         $$->addChild($3);
     }
     ;
@@ -539,7 +498,7 @@ opt_locking_clause_list:
 
 locking_clause_list:
     locking_clause {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOCKING_CLAUSE_LIST);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOCKING_CLAUSE_LIST);
         $$->addChild($1);
     }
     | locking_clause_list locking_clause {
@@ -550,7 +509,7 @@ locking_clause_list:
 
 locking_clause:
     TOKEN_FOR lock_strength opt_lock_table_list opt_lock_option {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOCKING_CLAUSE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOCKING_CLAUSE);
         $$->addChild($2); // lock_strength
         if ($3) $$->addChild($3); // opt_lock_table_list
         if ($4) $$->addChild($4); // opt_lock_option
@@ -558,22 +517,22 @@ locking_clause:
     ;
 
 lock_strength:
-    TOKEN_UPDATE { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOCK_STRENGTH, "UPDATE"); }
-    | TOKEN_SHARE  { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOCK_STRENGTH, "SHARE"); }
+    TOKEN_UPDATE { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOCK_STRENGTH, "UPDATE"); }
+    | TOKEN_SHARE  { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOCK_STRENGTH, "SHARE"); }
     ;
 
 opt_lock_table_list:
     /* empty */ { $$ = nullptr; }
     | TOKEN_OF table_name_list_for_delete { // Re-use table_name_list_for_delete for simplicity
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOCK_TABLE_LIST);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOCK_TABLE_LIST);
         $$->addChild($2); // table_name_list_for_delete
     }
     ;
 
 opt_lock_option:
     /* empty */ { $$ = nullptr; }
-    | TOKEN_NOWAIT { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOCK_OPTION, "NOWAIT"); }
-    | TOKEN_SKIP TOKEN_LOCKED { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOCK_OPTION, "SKIP LOCKED"); }
+    | TOKEN_NOWAIT { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOCK_OPTION, "NOWAIT"); }
+    | TOKEN_SKIP TOKEN_LOCKED { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOCK_OPTION, "SKIP LOCKED"); }
     ;
 
 /* --- FROM Clause and JOINs --- */
@@ -590,7 +549,7 @@ opt_from_clause:
 
 from_clause:
     TOKEN_FROM table_reference {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FROM_CLAUSE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FROM_CLAUSE);
         $$->addChild($2);
     }
     ;
@@ -602,7 +561,7 @@ table_reference:
 
 table_reference_inner:
     table_name_spec opt_alias {
-        MysqlParser::AstNode* ref_node = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_TABLE_REFERENCE);
+        MysqlParser::AstNode* ref_node = NEW_AST_NODE(MysqlParser::NodeType::NODE_TABLE_REFERENCE);
         ref_node->addChild($1); // Add table_name_spec as child ($1 is already an AstNode)
         if ($2) { ref_node->addChild($2); } // Add alias as child
         $$ = ref_node;
@@ -616,7 +575,7 @@ table_reference_inner:
     | TOKEN_LPAREN table_reference TOKEN_RPAREN opt_alias {
         MysqlParser::AstNode* sub_ref_item = $2;
         if ($4) {
-            MysqlParser::AstNode* aliased_sub_ref = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_TABLE_REFERENCE);
+            MysqlParser::AstNode* aliased_sub_ref = NEW_AST_NODE(MysqlParser::NodeType::NODE_TABLE_REFERENCE);
             aliased_sub_ref->addChild(sub_ref_item);
             aliased_sub_ref->addChild($4);
             $$ = aliased_sub_ref;
@@ -628,14 +587,14 @@ table_reference_inner:
 
 subquery:
     TOKEN_LPAREN select_statement TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SUBQUERY);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SUBQUERY);
         $$->addChild($2); // select_statement
     }
     ;
 
 derived_table:
     subquery { // Typically requires an alias, handled by table_reference_inner
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DERIVED_TABLE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_DERIVED_TABLE);
         $$->addChild($1); // subquery
     }
     ;
@@ -643,25 +602,25 @@ derived_table:
 // Handles NATURAL [INNER|LEFT|RIGHT [OUTER]] JOIN
 join_type_natural_spec:
     TOKEN_NATURAL opt_join_type {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_JOIN_TYPE_NATURAL_SPEC);
-        $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "NATURAL"));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_JOIN_TYPE_NATURAL_SPEC);
+        $$->addChild(NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "NATURAL"));
         if ($2) { // opt_join_type (e.g. LEFT node)
             $$->addChild($2);
         } else { // Pure NATURAL implies INNER
-            $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "INNER"));
+            $$->addChild(NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "INNER"));
         }
     }
     ;
 
 opt_join_type: // For non-NATURAL joins: INNER, LEFT [OUTER], RIGHT [OUTER], FULL [OUTER]
     /* empty */ { $$ = nullptr; } // Implicitly INNER if only TOKEN_JOIN is used
-    | TOKEN_INNER               { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "INNER"); }
-    | TOKEN_LEFT                { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "LEFT"); }
-    | TOKEN_LEFT TOKEN_OUTER    { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "LEFT OUTER"); }
-    | TOKEN_RIGHT               { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "RIGHT"); }
-    | TOKEN_RIGHT TOKEN_OUTER   { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "RIGHT OUTER"); }
-    | TOKEN_FULL                { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "FULL"); }
-    | TOKEN_FULL TOKEN_OUTER    { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "FULL OUTER"); }
+    | TOKEN_INNER               { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "INNER"); }
+    | TOKEN_LEFT                { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "LEFT"); }
+    | TOKEN_LEFT TOKEN_OUTER    { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "LEFT OUTER"); }
+    | TOKEN_RIGHT               { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "RIGHT"); }
+    | TOKEN_RIGHT TOKEN_OUTER   { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "RIGHT OUTER"); }
+    | TOKEN_FULL                { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "FULL"); }
+    | TOKEN_FULL TOKEN_OUTER    { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "FULL OUTER"); }
     ;
 
 
@@ -669,7 +628,7 @@ joined_table:
     table_reference join_type_natural_spec TOKEN_JOIN table_reference_inner opt_join_condition {
         // table_ref NATURAL [INNER|LEFT|RIGHT] JOIN table_ref_inner [ON|USING]
         // $2 is NODE_JOIN_TYPE_NATURAL_SPEC
-        MysqlParser::AstNode* join_node = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_JOIN_CLAUSE);
+        MysqlParser::AstNode* join_node = NEW_AST_NODE(MysqlParser::NodeType::NODE_JOIN_CLAUSE);
         std::string natural_join_type_str = $2->children[0]->value; // "NATURAL"
         if ($2->children.size() > 1) { // Has an explicit type like LEFT
             natural_join_type_str += " " + $2->children[1]->value; // "NATURAL LEFT"
@@ -692,9 +651,9 @@ joined_table:
             join_desc = explicit_join_type->value + " JOIN";
         } else { // Implicit INNER JOIN
             join_desc = "INNER JOIN"; // Default for JOIN without explicit type
-            explicit_join_type = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "INNER"); // Create node for AST
+            explicit_join_type = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "INNER"); // Create node for AST
         }
-        join_node = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_JOIN_CLAUSE, join_desc);
+        join_node = NEW_AST_NODE(MysqlParser::NodeType::NODE_JOIN_CLAUSE, join_desc);
         join_node->addChild($1); // Left table
         join_node->addChild(explicit_join_type); // The type node (created if was implicit)
         join_node->addChild($4); // Right table
@@ -718,12 +677,12 @@ joined_table:
         $$ = join_node;
     }
     | table_reference TOKEN_CROSS TOKEN_JOIN table_reference_inner {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_JOIN_CLAUSE, "CROSS JOIN");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_JOIN_CLAUSE, "CROSS JOIN");
         $$->addChild($1); // Left table
         $$->addChild($4); // Right table
     }
     | table_reference TOKEN_COMMA table_reference_inner { // Old style comma join implies CROSS JOIN
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_JOIN_CLAUSE, "CROSS JOIN");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_JOIN_CLAUSE, "CROSS JOIN");
         $$->addChild($1); // Left table
         $$->addChild($3); // Right table
     }
@@ -736,18 +695,18 @@ opt_join_condition:
 
 join_condition:
     TOKEN_ON expression_placeholder {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_JOIN_CONDITION_ON);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_JOIN_CONDITION_ON);
         $$->addChild($2); // expression_placeholder
     }
     | TOKEN_USING TOKEN_LPAREN identifier_list_for_using TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_JOIN_CONDITION_USING);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_JOIN_CONDITION_USING);
         $$->addChild($3); // identifier_list_for_using
     }
     ;
 
 identifier_list_for_using:
     identifier_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_COLUMN_LIST); // Re-use for list of identifiers
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_COLUMN_LIST); // Re-use for list of identifiers
         $$->addChild($1);
     }
     | identifier_list_for_using TOKEN_COMMA identifier_node {
@@ -764,7 +723,7 @@ opt_column_list:
 
 column_list_item_list:
     column_list_item {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_COLUMN_LIST);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_COLUMN_LIST);
         $$->addChild($1);
     }
     | column_list_item_list TOKEN_COMMA column_list_item {
@@ -779,7 +738,7 @@ column_list_item:
 
 expression_list:
     expression_placeholder {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "expr_list_wrapper");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_EXPRESSION_LIST);
         $$->addChild($1);
     }
     | expression_list TOKEN_COMMA expression_placeholder {
@@ -794,7 +753,7 @@ value_row:
 
 value_row_list:
     value_row {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "value_row_list_wrapper");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VALUE_ROW_LIST);
         $$->addChild($1);
     }
     | value_row_list TOKEN_COMMA value_row {
@@ -805,20 +764,18 @@ value_row_list:
 
 values_clause:
     TOKEN_VALUES value_row_list {
-        // Create a specific node for VALUES clause for clarity in AST
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "VALUES_CLAUSE"); // Placeholder type
-        // Consider creating NODE_VALUES_CLAUSE in mysql_ast.h
-        $$->addChild($2); // Add the value_row_list_wrapper
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VALUES_CLAUSE);
+        $$->addChild($2); // NODE_VALUE_ROW_LIST
     }
     ;
 
 insert_statement:
     TOKEN_INSERT TOKEN_INTO table_name_spec opt_column_list values_clause optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_INSERT_STATEMENT);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_INSERT_STATEMENT);
         $$->addChild($3); // table_name_spec
-        if ($4) $$->addChild($4); // opt_column_list (which is column_list_item_list or null)
-        else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_COLUMN_LIST)); // Add empty list if not present
+        $$->addChild($4); // opt_column_list (which is column_list_item_list or null)
         $$->addChild($5); // values_clause
+        parser_context->statement_.insert = MysqlParser::InsertStmt{$3, $4, $5};
     }
     // Add other forms of INSERT if needed (e.g., INSERT ... SELECT, INSERT ... SET)
     ;
@@ -834,32 +791,35 @@ value_for_insert:
 delete_statement:
     TOKEN_DELETE opt_delete_options TOKEN_FROM table_name_spec // Use table_name_spec
                  opt_where_clause opt_order_by_clause opt_limit_clause optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DELETE_STATEMENT);
-        if ($2) $$->addChild($2); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DELETE_OPTIONS));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_DELETE_STATEMENT);
+        $$->addChild($2); // opt_delete_options
         $$->addChild($4); // table_name_spec
-        if ($5) $$->addChild($5); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_WHERE_CLAUSE));
-        if ($6) $$->addChild($6); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ORDER_BY_CLAUSE));
-        if ($7) $$->addChild($7); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LIMIT_CLAUSE));
+        $$->addChild($5); // opt_where_clause
+        $$->addChild($6); // opt_order_by_clause
+        $$->addChild($7); // opt_limit_clause
+        parser_context->statement_.del = MysqlParser::DeleteStmt{$2, $4, nullptr, nullptr, nullptr, $5, $6, $7};
     }
     | TOKEN_DELETE opt_delete_options table_name_list_for_delete TOKEN_FROM table_reference // table_reference for multi-table
                  opt_where_clause optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DELETE_STATEMENT, "MULTI_TABLE_TARGET_LIST_FROM");
-        if ($2) $$->addChild($2); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DELETE_OPTIONS));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_DELETE_STATEMENT, "MULTI_TABLE_TARGET_LIST_FROM");
+        $$->addChild($2); // opt_delete_options
         $$->addChild($3); // table_name_list_for_delete
-        MysqlParser::AstNode* from_wrapper = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_FROM_CLAUSE);
+        MysqlParser::AstNode* from_wrapper = NEW_AST_NODE(MysqlParser::NodeType::NODE_FROM_CLAUSE);
         from_wrapper->addChild($5); // table_reference
         $$->addChild(from_wrapper);
-        if ($6) $$->addChild($6); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_WHERE_CLAUSE));
+        $$->addChild($6); // opt_where_clause
+        parser_context->statement_.del = MysqlParser::DeleteStmt{$2, nullptr, $3, from_wrapper, nullptr, $6, nullptr, nullptr};
     }
     | TOKEN_DELETE opt_delete_options TOKEN_FROM table_name_list_for_delete TOKEN_USING table_reference // table_reference for multi-table
                  opt_where_clause optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DELETE_STATEMENT, "MULTI_TABLE_FROM_USING");
-        if ($2) $$->addChild($2); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DELETE_OPTIONS));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_DELETE_STATEMENT, "MULTI_TABLE_FROM_USING");
+        $$->addChild($2); // opt_delete_options
         $$->addChild($4); // table_name_list_for_delete
-        MysqlParser::AstNode* using_wrapper = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_USING_CLAUSE);
+        MysqlParser::AstNode* using_wrapper = NEW_AST_NODE(MysqlParser::NodeType::NODE_USING_CLAUSE);
         using_wrapper->addChild($6); // table_reference
         $$->addChild(using_wrapper);
-        if ($7) $$->addChild($7); else $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_WHERE_CLAUSE));
+        $$->addChild($7); // opt_where_clause
+        parser_context->statement_.del = MysqlParser::DeleteStmt{$2, nullptr, $4, nullptr, using_wrapper, $7, nullptr, nullptr};
     }
     ;
 
@@ -870,7 +830,7 @@ opt_delete_options:
 
 delete_option_item_list:
     delete_option {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_DELETE_OPTIONS);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_DELETE_OPTIONS);
         $$->addChild($1);
     }
     | delete_option_item_list delete_option {
@@ -880,14 +840,14 @@ delete_option_item_list:
     ;
 
 delete_option:
-    TOKEN_LOW_PRIORITY { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "LOW_PRIORITY"); }
-    | TOKEN_QUICK      { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "QUICK"); }
-    | TOKEN_IGNORE_SYM { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "IGNORE"); }
+    TOKEN_LOW_PRIORITY { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "LOW_PRIORITY"); }
+    | TOKEN_QUICK      { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "QUICK"); }
+    | TOKEN_IGNORE_SYM { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "IGNORE"); }
     ;
 
 table_name_list_for_delete: // List of tables to delete FROM in multi-table delete
     table_name_spec { // Use table_name_spec here
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_TABLE_NAME_LIST);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_TABLE_NAME_LIST);
         $$->addChild($1);
     }
     | table_name_list_for_delete TOKEN_COMMA table_name_spec {
@@ -899,27 +859,25 @@ table_name_list_for_delete: // List of tables to delete FROM in multi-table dele
 /* --- SET Statement Rules --- */
 // For Query 1: SET TRANSACTION ISOLATION LEVEL ...
 isolation_level_spec:
-    TOKEN_READ TOKEN_COMMITTED         { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "READ COMMITTED"); }
-    | TOKEN_READ TOKEN_UNCOMMITTED     { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "READ UNCOMMITTED"); }
-    | TOKEN_REPEATABLE TOKEN_READ      { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "REPEATABLE READ"); }
-    | TOKEN_SERIALIZABLE              { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "SERIALIZABLE"); }
+    TOKEN_READ TOKEN_COMMITTED         { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "READ COMMITTED"); }
+    | TOKEN_READ TOKEN_UNCOMMITTED     { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "READ UNCOMMITTED"); }
+    | TOKEN_REPEATABLE TOKEN_READ      { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "REPEATABLE READ"); }
+    | TOKEN_SERIALIZABLE              { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "SERIALIZABLE"); }
     ;
 
 transaction_characteristic:
     TOKEN_ISOLATION TOKEN_LEVEL isolation_level_spec {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "ISOLATION_LEVEL"); // Placeholder type
-        // Consider NODE_TXN_ISOLATION_LEVEL in mysql_ast.h
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_TXN_ISOLATION_LEVEL);
         $$->addChild($3); // isolation_level_spec
     }
     // Add other characteristics like READ WRITE / READ ONLY if needed
-    // | TOKEN_READ TOKEN_WRITE { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "READ WRITE"); }
-    // | TOKEN_READ TOKEN_ONLY { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "READ ONLY"); } // Assuming TOKEN_ONLY exists
+    // | TOKEN_READ TOKEN_WRITE { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "READ WRITE"); }
+    // | TOKEN_READ TOKEN_ONLY { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "READ ONLY"); } // Assuming TOKEN_ONLY exists
     ;
 
 transaction_characteristic_list:
     transaction_characteristic {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "TXN_CHAR_LIST"); // Placeholder type
-        // Consider NODE_TXN_CHARACTERISTIC_LIST in mysql_ast.h
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_TXN_CHARACTERISTIC_LIST);
         $$->addChild($1);
     }
     | transaction_characteristic_list TOKEN_COMMA transaction_characteristic {
@@ -930,58 +888,75 @@ transaction_characteristic_list:
 
 set_transaction_statement:
     TOKEN_SESSION TOKEN_TRANSACTION transaction_characteristic_list {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_SESSION_TRANSACTION"); // Or more specific type
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_SESSION_TRANSACTION"); // Or more specific type
         // Consider NODE_SET_TRANSACTION_STATEMENT in mysql_ast.h
-        $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "SESSION")); // Add scope
+        $$->addChild(NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "SESSION")); // Add scope
         $$->addChild($3); // transaction_characteristic_list
+        if (parser_context) parser_context->internal_record_transaction($3, "SESSION");
     }
     | TOKEN_GLOBAL TOKEN_TRANSACTION transaction_characteristic_list {
-         $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_GLOBAL_TRANSACTION");
-         $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "GLOBAL"));
+         $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_GLOBAL_TRANSACTION");
+         $$->addChild(NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "GLOBAL"));
          $$->addChild($3);
+         if (parser_context) parser_context->internal_record_transaction($3, "GLOBAL");
     }
     | TOKEN_TRANSACTION transaction_characteristic_list { // Default to SESSION
-         $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_TRANSACTION");
+         $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_TRANSACTION");
          // Could add an implicit SESSION scope node if desired for AST consistency
          $$->addChild($2); // transaction_characteristic_list
+         if (parser_context) parser_context->internal_record_transaction($2, nullptr);
     }
     ;
 
 set_statement:
-    TOKEN_SET set_names_stmt optional_semicolon { $$ = $2; }
-    | TOKEN_SET set_charset_stmt optional_semicolon { $$ = $2; }
+    TOKEN_SET set_names_stmt optional_semicolon {
+        $$ = $2;
+        parser_context->statement_.set = MysqlParser::SetStmt{nullptr, $2, nullptr, nullptr};
+    }
+    | TOKEN_SET set_charset_stmt optional_semicolon {
+        $$ = $2;
+        parser_context->statement_.set = MysqlParser::SetStmt{nullptr, nullptr, $2, nullptr};
+    }
     | TOKEN_SET set_option_list optional_semicolon {
-        // $2 is the "set_var_assignments" node.
+        // $2 is the NODE_VARIABLE_ASSIGNMENT_LIST node.
         // The set_statement node should probably wrap this for consistency.
-        MysqlParser::AstNode* set_vars_stmt = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_VARIABLES");
+        MysqlParser::AstNode* set_vars_stmt = NEW_AST_NODE(MysqlParser::NodeType::NODE_SET_STATEMENT, "SET_VARIABLES");
         set_vars_stmt->addChild($2);
         $$ = set_vars_stmt;
+        parser_context->statement_.set = MysqlParser::SetStmt{$2, nullptr, nullptr, nullptr};
+    }
+    | TOKEN_SET set_transaction_statement optional_semicolon {
+        $$ = $2;
+        // The characteristic list follows the optional scope node
+        parser_context->statement_.set = MysqlParser::SetStmt{nullptr, nullptr, nullptr, $2->children.back()};
     }
-    | TOKEN_SET set_transaction_statement optional_semicolon { $$ = $2; }
     ;
 
 set_names_stmt:
     TOKEN_NAMES charset_name_or_default {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SET_NAMES);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SET_NAMES);
         $$->addChild($2);
+        if (parser_context) parser_context->internal_record_set_names($2, nullptr);
     }
     | TOKEN_NAMES charset_name_or_default TOKEN_COLLATE collation_name_choice {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SET_NAMES);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SET_NAMES);
         $$->addChild($2);
         $$->addChild($4);
+        if (parser_context) parser_context->internal_record_set_names($2, $4);
     }
     ;
 
 set_charset_stmt:
     TOKEN_CHARACTER TOKEN_SET charset_name_or_default {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SET_CHARSET);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SET_CHARSET);
         $$->addChild($3);
+        if (parser_context) parser_context->internal_record_set_charset($3);
     }
     ;
 
 charset_name_or_default:
     string_literal_node { $$ = $1; }
-    | TOKEN_DEFAULT     { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "DEFAULT"); }
+    | TOKEN_DEFAULT     { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "DEFAULT"); }
     | identifier_node   { $$ = $1; }
     ;
 
@@ -992,8 +967,7 @@ collation_name_choice:
 
 set_option_list: // List of variable assignments: @a=1, GLOBAL b=2
     set_option {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "set_var_assignments_list"); // Placeholder type
-        // Consider NODE_VARIABLE_ASSIGNMENT_LIST in mysql_ast.h
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_ASSIGNMENT_LIST);
         $$->addChild($1); // $1 is NODE_VARIABLE_ASSIGNMENT
     }
     | set_option_list TOKEN_COMMA set_option {
@@ -1004,9 +978,10 @@ set_option_list: // List of variable assignments: @a=1, GLOBAL b=2
 
 set_option:
     variable_to_set TOKEN_EQUAL expression_placeholder {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_ASSIGNMENT);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_ASSIGNMENT);
         $$->addChild($1);
         $$->addChild($3);
+        if (parser_context) parser_context->internal_record_assignment($1, $3);
     }
     ;
 
@@ -1014,20 +989,19 @@ variable_to_set:
     user_variable { $$ = $1; }
     | system_variable_qualified { $$ = $1; }
     | variable_scope system_variable_unqualified {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2->value); // $2 is identifier_node
+        $$ = RENAME_IDENTIFIER(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2); // $2 is identifier_node
         $$->addChild($1); // scope node
-        delete $2; // $2's value copied, node itself deleted
     }
     | system_variable_unqualified {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $1->value); // $1 is identifier_node
+        $$ = RENAME_IDENTIFIER(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $1); // $1 is identifier_node
         // No explicit scope means session or implied context. AST can reflect this.
-        delete $1; // $1's value copied, node itself deleted
     }
     ;
 
 user_variable:
     TOKEN_SPECIAL TOKEN_IDENTIFIER {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_USER_VARIABLE, std::move(*$2)); // $2 is str_val
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_USER_VARIABLE, std::move(*$2)); // $2 is str_val
+        $$->symbol = parser_context->internal_intern($$->value);
         delete $2;
     }
     ;
@@ -1038,36 +1012,33 @@ system_variable_unqualified:
 
 system_variable_qualified:
     TOKEN_DOUBLESPECIAL identifier_node {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2->value);
+        $$ = RENAME_IDENTIFIER(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2);
         // Could add an implicit scope node if desired, e.g. "SESSION" if @@var implies session
-        delete $2;
     }
     | TOKEN_GLOBAL_VAR_PREFIX identifier_node {
-        MysqlParser::AstNode* scope_node = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "GLOBAL");
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2->value);
+        MysqlParser::AstNode* scope_node = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "GLOBAL");
+        $$ = RENAME_IDENTIFIER(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2);
         $$->addChild(scope_node);
-        delete $2;
     }
     | TOKEN_SESSION_VAR_PREFIX identifier_node {
-        MysqlParser::AstNode* scope_node = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "SESSION");
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2->value);
+        MysqlParser::AstNode* scope_node = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "SESSION");
+        $$ = RENAME_IDENTIFIER(MysqlParser::NodeType::NODE_SYSTEM_VARIABLE, $2);
         $$->addChild(scope_node);
-        delete $2;
     }
     ;
 
 variable_scope:
-    TOKEN_GLOBAL        { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "GLOBAL"); }
-    | TOKEN_SESSION       { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "SESSION"); }
-    | TOKEN_PERSIST       { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "PERSIST"); }
-    | TOKEN_PERSIST_ONLY  { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "PERSIST_ONLY"); }
+    TOKEN_GLOBAL        { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "GLOBAL"); }
+    | TOKEN_SESSION       { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "SESSION"); }
+    | TOKEN_PERSIST       { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "PERSIST"); }
+    | TOKEN_PERSIST_ONLY  { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_VARIABLE_SCOPE, "PERSIST_ONLY"); }
     ;
 
 /* --- Common Optional Clauses --- */
 opt_where_clause:
     /* empty */ { $$ = nullptr; }
     | TOKEN_WHERE expression_placeholder {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_WHERE_CLAUSE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_WHERE_CLAUSE);
         $$->addChild($2);
     }
     ;
@@ -1075,7 +1046,7 @@ opt_where_clause:
 opt_having_clause:
     /* empty */ { $$ = nullptr; }
     | TOKEN_HAVING expression_placeholder {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_HAVING_CLAUSE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_HAVING_CLAUSE);
         $$->addChild($2);
     }
     ;
@@ -1087,7 +1058,7 @@ opt_order_by_clause:
 
 order_by_list:
     order_by_item {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ORDER_BY_CLAUSE); // This is the main clause node
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_ORDER_BY_CLAUSE); // This is the main clause node
         $$->addChild($1); // order_by_item
     }
     | order_by_list TOKEN_COMMA order_by_item {
@@ -1098,7 +1069,7 @@ order_by_list:
 
 order_by_item:
     expression_placeholder opt_asc_desc {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ORDER_BY_ITEM);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_ORDER_BY_ITEM);
         $$->addChild($1); // expression_placeholder
         if ($2) { // opt_asc_desc (ASC/DESC keyword node)
             $$->addChild($2);
@@ -1108,21 +1079,21 @@ order_by_item:
 
 opt_asc_desc:
     /* empty */       { $$ = nullptr; }
-    | TOKEN_ASC       { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "ASC"); }
-    | TOKEN_DESC      { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "DESC"); }
+    | TOKEN_ASC       { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "ASC"); }
+    | TOKEN_DESC      { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "DESC"); }
     ;
 
 opt_limit_clause:
     /* empty */ { $$ = nullptr; }
     | TOKEN_LIMIT number_literal_node { // LIMIT count
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LIMIT_CLAUSE);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LIMIT_CLAUSE);
         $$->addChild($2); // count
     }
     | TOKEN_LIMIT number_literal_node TOKEN_COMMA number_literal_node { // LIMIT offset, count
         // Standard SQL: LIMIT row_count OFFSET offset_row
         // MySQL legacy: LIMIT offset_row, row_count
         // Current AST: first child is offset, second is count for this form.
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LIMIT_CLAUSE, "OFFSET_COUNT");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LIMIT_CLAUSE, "OFFSET_COUNT");
         $$->addChild($2); // offset
         $$->addChild($4); // count
     }
@@ -1131,7 +1102,7 @@ opt_limit_clause:
     | TOKEN_LIMIT number_literal_node TOKEN_OFFSET number_literal_node { // LIMIT count OFFSET offset
         // Standard SQL: LIMIT row_count OFFSET offset_row
         // Current AST: first child is count, second is offset for this form.
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LIMIT_CLAUSE, "COUNT_OFFSET");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LIMIT_CLAUSE, "COUNT_OFFSET");
         $$->addChild($2); // count
         $$->addChild($4); // offset
     }
@@ -1144,7 +1115,7 @@ opt_group_by_clause:
 
 group_by_list:
     grouping_element {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_GROUP_BY_CLAUSE); // Main clause node
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_GROUP_BY_CLAUSE); // Main clause node
         $$->addChild($1); // grouping_element
     }
     | group_by_list TOKEN_COMMA grouping_element {
@@ -1161,7 +1132,7 @@ grouping_element:
 /* --- SHOW Statement Rules --- */
 show_statement:
     TOKEN_SHOW show_full_modifier show_what optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SHOW_STATEMENT);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SHOW_STATEMENT);
         if ($2) $$->addChild($2); // show_full_modifier (can be null)
         $$->addChild($3);       // show_what
     }
@@ -1169,15 +1140,15 @@ show_statement:
 
 show_full_modifier:
     /* empty */     { $$ = nullptr; }
-    | TOKEN_FULL    { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SHOW_OPTION_FULL, "FULL"); }
+    | TOKEN_FULL    { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SHOW_OPTION_FULL, "FULL"); }
     ;
 
 show_what:
     TOKEN_DATABASES {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SHOW_TARGET_DATABASES, "DATABASES");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SHOW_TARGET_DATABASES, "DATABASES");
     }
     | TOKEN_FIELDS show_from_or_in table_specification {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_SHOW_OPTION_FIELDS, "FIELDS");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_SHOW_OPTION_FIELDS, "FIELDS");
         // $2 is show_from_or_in which is just a keyword placeholder for now, so not adding as child.
         $$->addChild($3); // table_specification
     }
@@ -1187,13 +1158,13 @@ show_what:
     ;
 
 show_from_or_in:
-    TOKEN_FROM { $$ = nullptr; /* keyword only, not stored as node */ }
-    | TOKEN_IN   { $$ = nullptr; /* keyword only, not stored as node */ }
+    TOKEN_FROM { /* keyword only, not stored as node */ }
+    | TOKEN_IN   { /* keyword only, not stored as node */ }
     ;
 
 table_specification: // Used by SHOW FIELDS FROM table_name
     table_name_spec { // Re-use table_name_spec which handles identifier_node and qualified_identifier_node
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_TABLE_SPECIFICATION);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_TABLE_SPECIFICATION);
         $$->addChild($1); // table_name_spec node which contains table_name or schema.table_name
     }
     ;
@@ -1202,12 +1173,12 @@ table_specification: // Used by SHOW FIELDS FROM table_name
 /* --- BEGIN/COMMIT Statement Rules --- */
 begin_statement:
     TOKEN_BEGIN optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_BEGIN_STATEMENT, "BEGIN");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_BEGIN_STATEMENT, "BEGIN");
     }
     ;
 commit_statement:
     TOKEN_COMMIT optional_semicolon {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_COMMIT_STATEMENT, "COMMIT");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_COMMIT_STATEMENT, "COMMIT");
     }
     ;
 
@@ -1215,22 +1186,35 @@ commit_statement:
 expression_placeholder:
     simple_expression { $$ = $1; }
     | expression_placeholder TOKEN_AND expression_placeholder {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_LOGICAL_AND_EXPRESSION);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_LOGICAL_AND_EXPRESSION);
         $$->addChild($1);
         $$->addChild($3);
     }
-    | expression_placeholder comparison_operator expression_placeholder {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_COMPARISON_EXPRESSION, $2->value);
+    | expression_placeholder comparison_operator expression_placeholder %prec TOKEN_EQUAL {
+        // %prec: comparison_operator is a nonterminal, so the rule has no
+        // precedence of its own, and `a = 1 AND b = 2` would otherwise parse
+        // as `a = (1 AND (b = 2))`
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_COMPARISON_EXPRESSION, $2->value);
         delete $2;
         $$->addChild($1);
         $$->addChild($3);
     }
+    | expression_placeholder TOKEN_IN TOKEN_LPAREN expression_list TOKEN_RPAREN {
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_IN_EXPRESSION, "IN");
+        $$->addChild($1);
+        $$->addChild($4); // NODE_EXPRESSION_LIST
+    }
+    | expression_placeholder TOKEN_NOT TOKEN_IN TOKEN_LPAREN expression_list TOKEN_RPAREN {
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_IN_EXPRESSION, "NOT IN");
+        $$->addChild($1);
+        $$->addChild($5); // NODE_EXPRESSION_LIST
+    }
     | expression_placeholder TOKEN_IS TOKEN_NULL_KEYWORD { // Covers `expr IS NULL`
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_IS_NULL_EXPRESSION);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_IS_NULL_EXPRESSION);
         $$->addChild($1); // The expression part
     }
     | expression_placeholder TOKEN_IS TOKEN_NOT TOKEN_NULL_KEYWORD { // Covers `expr IS NOT NULL`
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_IS_NOT_NULL_EXPRESSION);
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_IS_NOT_NULL_EXPRESSION);
         $$->addChild($1); // The expression part
     }
     | match_against_expression { $$ = $1; }
@@ -1243,41 +1227,40 @@ simple_expression:
     | identifier_node       { $$ = $1; }
     | user_variable         { $$ = $1; }
     | system_variable_qualified { $$ = $1; }
-    | TOKEN_DEFAULT         { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "DEFAULT"); }
+    | TOKEN_DEFAULT         { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "DEFAULT"); }
     | aggregate_function_call { $$ = $1; }
     | function_call_placeholder {$$ = $1; }
     | TOKEN_LPAREN expression_placeholder TOKEN_RPAREN { $$ = $2; } // Important for `(expr IS NOT NULL)`
     | simple_expression TOKEN_PLUS simple_expression {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "+");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "+");
         $$->addChild($1); $$->addChild($3);
     }
     | simple_expression TOKEN_MINUS simple_expression {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "-");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "-");
         $$->addChild($1); $$->addChild($3);
     }
     | simple_expression TOKEN_ASTERISK simple_expression {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "*");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "*");
         $$->addChild($1); $$->addChild($3);
     }
     | simple_expression TOKEN_DIVIDE simple_expression {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "/");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "/");
         $$->addChild($1); $$->addChild($3);
     }
     | TOKEN_MINUS simple_expression %prec UMINUS {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "-");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "-");
         $$->addChild($2); // Child is the expression being negated
     }
     ;
 
 opt_search_modifier:
     /* empty */ { $$ = nullptr; }
-    | TOKEN_IN TOKEN_BOOLEAN TOKEN_MODE { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_KEYWORD, "IN BOOLEAN MODE"); }
+    | TOKEN_IN TOKEN_BOOLEAN TOKEN_MODE { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_KEYWORD, "IN BOOLEAN MODE"); }
     ;
 
 match_against_expression:
     TOKEN_MATCH TOKEN_LPAREN expression_list TOKEN_RPAREN TOKEN_AGAINST TOKEN_LPAREN expression_placeholder opt_search_modifier TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "MATCH_AGAINST"); // Placeholder type
-        // Consider NODE_MATCH_AGAINST_EXPRESSION in mysql_ast.h
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_MATCH_AGAINST_EXPRESSION);
         $$->addChild($3); // expression_list (columns)
         $$->addChild($7); // expression_placeholder (search string)
         if ($8) $$->addChild($8); // opt_search_modifier
@@ -1286,51 +1269,51 @@ match_against_expression:
 
 aggregate_function_call:
     TOKEN_COUNT TOKEN_LPAREN TOKEN_ASTERISK TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "COUNT");
-        $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_ASTERISK, "*"));
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "COUNT");
+        $$->addChild(NEW_AST_NODE(MysqlParser::NodeType::NODE_ASTERISK, "*"));
     }
     | TOKEN_COUNT TOKEN_LPAREN expression_placeholder TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "COUNT");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "COUNT");
         $$->addChild($3);
     }
     | TOKEN_SUM TOKEN_LPAREN expression_placeholder TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "SUM");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "SUM");
         $$->addChild($3);
     }
     | TOKEN_AVG TOKEN_LPAREN expression_placeholder TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "AVG");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "AVG");
         $$->addChild($3);
     }
     | TOKEN_MAX TOKEN_LPAREN expression_placeholder TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "MAX");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "MAX");
         $$->addChild($3);
     }
     | TOKEN_MIN TOKEN_LPAREN expression_placeholder TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "MIN");
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_AGGREGATE_FUNCTION_CALL, "MIN");
         $$->addChild($3);
     }
     ;
 
 comparison_operator:
-    TOKEN_EQUAL         { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "="); }
-    | TOKEN_LESS          { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "<"); }
-    | TOKEN_GREATER       { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, ">"); }
-    | TOKEN_LESS_EQUAL    { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "<="); }
-    | TOKEN_GREATER_EQUAL { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, ">="); }
-    | TOKEN_NOT_EQUAL     { $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_OPERATOR, "!="); }
+    TOKEN_EQUAL         { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "="); }
+    | TOKEN_LESS          { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "<"); }
+    | TOKEN_GREATER       { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, ">"); }
+    | TOKEN_LESS_EQUAL    { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "<="); }
+    | TOKEN_GREATER_EQUAL { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, ">="); }
+    | TOKEN_NOT_EQUAL     { $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_OPERATOR, "!="); }
     ;
 
 function_call_placeholder:
     identifier_node TOKEN_LPAREN opt_expression_placeholder_list TOKEN_RPAREN {
-        $$ = new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "FUNC_CALL:" + $1->value); // Placeholder type
-        // Consider NODE_FUNCTION_CALL in mysql_ast.h
+        $$ = NEW_AST_NODE(MysqlParser::NodeType::NODE_FUNCTION_CALL, $1->value); // Value is the function name
+        $$->symbol = $1->symbol;
         $$->addChild($1);
         if ($3) {
             $$->addChild($3); // $3 is expression_list or null
         } else {
             // Add an empty list node for functions with no arguments, e.g., NOW()
             // This ensures the function call node always has a child for arguments, even if empty.
-            $$->addChild(new MysqlParser::AstNode(MysqlParser::NodeType::NODE_EXPRESSION_PLACEHOLDER, "empty_arg_list_wrapper"));
+            $$->addChild(NEW_AST_NODE(MysqlParser::NodeType::NODE_EXPRESSION_LIST));
         }
     }
     ;
@@ -1343,7 +1326,51 @@ opt_expression_placeholder_list:
 %%
 /* C code to follow grammar rules */
 
-// void mysql_yyerror(yyscan_t yyscanner, MysqlParser::Parser* parser_context, const char* msg) {
+// Where the digest is in a run of literals: "1, 2, 3" is folded as one
+// placeholder, so the comma is held back until the next token shows whether
+// the run goes on.
+enum DigestLiteralRun : uint8_t { DIGEST_NO_RUN, DIGEST_AFTER_LITERAL, DIGEST_AFTER_LITERAL_COMMA };
+
+void MysqlParser::ParserContext::internal_digest_token(int token, const std::string* identifier) {
+    if (token == TOKEN_SEMICOLON) return; // "SELECT 1" and "SELECT 1;" are the same statement
+    if (token == TOKEN_NUMBER_LITERAL || token == TOKEN_STRING_LITERAL) {
+        if (digest_literals_ == DIGEST_NO_RUN) internal_digest_value(TOKEN_NUMBER_LITERAL);
+        digest_literals_ = DIGEST_AFTER_LITERAL;
+        return;
+    }
+    if (token == TOKEN_COMMA && digest_literals_ == DIGEST_AFTER_LITERAL) {
+        digest_literals_ = DIGEST_AFTER_LITERAL_COMMA;
+        return;
+    }
+    if (digest_literals_ == DIGEST_AFTER_LITERAL_COMMA) internal_digest_value(TOKEN_COMMA);
+    digest_literals_ = DIGEST_NO_RUN;
+    if (token <= 0) return; // End of input
+    internal_digest_value(static_cast<uint64_t>(token));
+    if (token == TOKEN_IDENTIFIER && identifier) internal_digest_bytes(*identifier);
+}
+
+// Entry point called by mysql_yyparse: the Flex scanner (or the tokens of a
+// TokenBuffer) plus ParseLimits accounting. Tokens and parenthesis depth are counted here; once any budget
+// is spent the next call returns TOKEN_LIMIT_EXCEEDED, which no rule accepts,
+// so the parse aborts at once.
+int mysql_yylex(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlParser::ParserContext* parser_context) {
+    if (!parser_context->internal_charge_token()) {
+        return TOKEN_LIMIT_EXCEEDED;
+    }
+    MYSQL_TRACE(lex_start);
+    int token = parser_context->replay_ ? parser_context->internal_replay_token(yylval_param)
+                                        : mysql_yylex_raw(yylval_param, yyscanner, parser_context);
+    MYSQL_TRACE1(lex_done, token);
+    if (token == TOKEN_LPAREN) {
+        parser_context->internal_enter_paren();
+    } else if (token == TOKEN_RPAREN) {
+        parser_context->internal_leave_paren();
+    }
+    parser_context->internal_digest_token(token, token == TOKEN_IDENTIFIER ? yylval_param->str_val : nullptr);
+    return token;
+}
+
+// void mysql_yyerror(yyscan_t yyscanner, MysqlParser::ParserContext* parser_context, const char* msg) {
 //    if (parser_context) {
 //        parser_context->internal_add_error(msg);
 //    } else {
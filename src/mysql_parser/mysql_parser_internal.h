@@ -0,0 +1,193 @@
+#ifndef MYSQL_PARSER_INTERNAL_H
+#define MYSQL_PARSER_INTERNAL_H
+
+// Private interface between MysqlParser::Parser and the Bison/Flex generated code.
+// Not installed; include only from src/mysql_parser.
+
+#include "mysql_parser/mysql_ast.h"
+#include "mysql_parser/mysql_parser.h" // For ParseLimits, ParseStatus
+#include "mysql_parser/mysql_query_comments.h"
+#include "mysql_parser/mysql_session_state.h"
+#include "mysql_parser/mysql_statement.h"
+#include "mysql_parser/mysql_symbol_table.h"
+#include "mysql_parser/mysql_token_buffer.h"
+#include "mysql_trace.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+typedef void* yyscan_t; // Should be the same opaque type for Flex
+union MYSQL_YYSTYPE;   // Bison semantic value, see mysql_parser.tab.h
+
+namespace MysqlParser {
+
+class ParserContext {
+public:
+    ParserContext() = default;
+    ~ParserContext();
+
+    ParserContext(const ParserContext&) = delete;
+    ParserContext& operator=(const ParserContext&) = delete;
+
+    // Fires the parse_* tracepoints around run_parse()
+    std::unique_ptr<AstNode> parse(const char* sql_query, size_t sql_len, const ParseLimits* limits = nullptr);
+    std::unique_ptr<AstNode> run_parse(const char* sql_query, size_t sql_len, const ParseLimits* limits);
+    std::unique_ptr<AstNode> finish_parse(int parse_result); // Result and errors once mysql_yyparse() returned
+    bool ensure_scanner(); // Acquires scanner_state_ from the pool if not yet held
+    void reset_parse_state();
+    void apply_session_changes(); // Of a successful parse, to session_state_
+
+    // Hand-written recognizer for the commonest statement shapes, tried before
+    // the grammar (see mysql_fast_path.cpp). Builds the tree and side effects
+    // the grammar would; returns false at the first thing it does not handle,
+    // leaving partial state that reset_parse_state() clears.
+    bool internal_fast_parse(const char* sql_query, size_t sql_len);
+
+    // TokenBuffer support (see mysql_token_buffer.cpp). tokenize() runs the
+    // scanner over the whole query into out; parse(tokens) runs the grammar
+    // with mysql_yylex reading tokens through internal_replay_token() instead
+    // of the scanner.
+    bool tokenize(const char* sql_query, size_t sql_len, TokenBuffer& out);
+    std::unique_ptr<AstNode> parse(const TokenBuffer& tokens, const ParseLimits* limits);
+    int internal_replay_token(union MYSQL_YYSTYPE* yylval_param);
+
+    // Internal methods for Bison/Flex interaction
+    void internal_set_ast(AstNode* root);
+    // Sets the AST of a complete statement; the grammar has already filled in
+    // the member of statement_ for kind
+    void internal_set_statement(StatementKind kind, AstNode* root);
+    void internal_add_error(const std::string& msg);
+    void internal_add_error_at(const std::string& msg, int line, int column);
+
+    // ParseLimits accounting, called from mysql_yylex and grammar actions.
+    // internal_charge_token() returns false once any budget is spent.
+    bool internal_charge_token() {
+        if (status_ != ParseStatus::Ok) return false;
+        if (!limits_active_) return true;
+        ++token_count_;
+        if (limits_.max_tokens && token_count_ > limits_.max_tokens) {
+            status_ = ParseStatus::TokensExceeded;
+            return false;
+        }
+        if (limits_.max_time_us && token_count_ % limits_.time_check_interval == 0 &&
+            std::chrono::steady_clock::now() > deadline_) {
+            status_ = ParseStatus::DeadlineExceeded;
+            return false;
+        }
+        return true;
+    }
+    void internal_charge_node() {
+        MYSQL_TRACE(node_new);
+        if (limits_active_ && limits_.max_nodes && ++node_count_ > limits_.max_nodes && status_ == ParseStatus::Ok) {
+            status_ = ParseStatus::NodesExceeded;
+        }
+    }
+    void internal_enter_paren() {
+        if (limits_active_ && limits_.max_depth && ++depth_ > limits_.max_depth && status_ == ParseStatus::Ok) {
+            status_ = ParseStatus::DepthExceeded;
+        }
+    }
+    void internal_leave_paren() {
+        if (depth_) --depth_;
+    }
+    // True if the parse was stopped by ParseLimits rather than by a syntax error
+    bool internal_limit_exceeded() const {
+        return status_ != ParseStatus::Ok && status_ != ParseStatus::SyntaxError && status_ != ParseStatus::ScannerError;
+    }
+
+    // Session-state tracking for SET statements; no-ops unless session_state_ is set.
+    // Recorded changes are applied to session_state_ only if the parse succeeds.
+    void internal_record_assignment(const AstNode* variable, const AstNode* value);
+    void internal_record_set_names(const AstNode* charset, const AstNode* collation);
+    void internal_record_set_charset(const AstNode* charset);
+    void internal_record_transaction(const AstNode* characteristics, const char* scope);
+
+    // Comment recording from the lexer. body/length is the comment without its
+    // delimiters; offset is where body starts in the query text.
+    void internal_record_comment(CommentKind kind, const char* body, size_t length, size_t offset);
+    // A byte >= 0x80 that is not part of a UTF-8 identifier character. Only the
+    // first byte of each run of such bytes is reported.
+    void internal_invalid_utf8_byte(size_t offset) {
+        if (offset != invalid_utf8_end_) {
+            internal_add_error("Lexer: Invalid or unsupported UTF-8 sequence at offset " + std::to_string(offset));
+        }
+        invalid_utf8_end_ = offset + 1;
+    }
+    void internal_begin_comment(CommentKind kind, size_t body_offset) {
+        comment_kind_ = kind;
+        comment_start_ = body_offset;
+    }
+
+    // Symbol for an identifier when a SymbolTable is attached, looked up
+    // through a small per-parser cache before the shared table
+    Symbol internal_intern(const std::string& name) {
+        return symbols_ ? intern_cached(name) : kNoSymbol;
+    }
+    Symbol intern_cached(const std::string& name);
+
+    // Statement digest (Parser::getDigest()), folded in by mysql_yylex one
+    // token at a time: FNV-1a over token numbers and identifier bytes.
+    // internal_digest_token() is defined with the grammar, which owns the
+    // token numbers; identifier is the text of a TOKEN_IDENTIFIER.
+    static constexpr uint64_t kDigestSeed = 0xcbf29ce484222325ULL;
+    void internal_digest_token(int token, const std::string* identifier);
+    void internal_digest_value(uint64_t v) {
+        digest_ = (digest_ ^ v) * 0x100000001b3ULL;
+    }
+    void internal_digest_bytes(const std::string& s) {
+        for (unsigned char c : s) digest_ = (digest_ ^ c) * 0x100000001b3ULL;
+    }
+    uint64_t internal_digest() const;
+
+    std::unique_ptr<AstNode> ast_root_;
+    Statement statement_; // Typed clauses of ast_root_ (Parser::getStatement())
+    std::vector<std::string> errors_;
+    yyscan_t scanner_state_ = nullptr; // Acquired from the scanner pool on first parse
+    SessionState* session_state_ = nullptr; // Not owned
+    // Assignments of the statement being parsed; reset erases the variable
+    // (SET x = DEFAULT) so that the state matches a session that never set it
+    struct PendingSessionChange {
+        SessionVariable variable;
+        bool reset;
+    };
+    std::vector<PendingSessionChange> pending_session_changes_;
+    QueryComments comments_;
+    CommentKind comment_kind_ = CommentKind::Block; // Of the /* comment being scanned
+    size_t comment_start_ = 0;
+    // Byte range of the token the scanner last returned, kept by the lexer's
+    // YY_USER_ACTION for tokenize()
+    size_t token_start_ = 0;
+    size_t token_end_ = 0;
+    const TokenBuffer* replay_ = nullptr; // Set during parse(tokens)
+    size_t replay_token_ = 0; // Next token of replay_ to hand to the grammar
+    size_t replay_event_ = 0;
+    size_t invalid_utf8_end_ = SIZE_MAX; // Offset just past the last invalid byte
+    SymbolTable* symbols_ = nullptr; // Not owned
+    bool fast_path_ = true; // Parser::setFastPath()
+    struct SymbolCacheEntry {
+        uint64_t hash;
+        Symbol symbol;
+    };
+    static constexpr size_t kSymbolCacheSize = 256; // Direct-mapped by name hash
+    std::unique_ptr<SymbolCacheEntry[]> symbol_cache_; // Allocated when a table is attached
+    uint64_t digest_ = kDigestSeed;
+    uint8_t digest_literals_ = 0; // DigestLiteralRun state, see internal_digest_token()
+
+    ParseStatus status_ = ParseStatus::Ok;
+    ParseLimits limits_;
+    bool limits_active_ = false;
+    size_t token_count_ = 0;
+    size_t node_count_ = 0;
+    size_t depth_ = 0;
+    std::chrono::steady_clock::time_point deadline_;
+};
+
+} // namespace MysqlParser
+
+// Declaration for mysql_yyerror, which is called by Bison's mysql_yyparse.
+// As both generated parser and this definition will be C++, extern "C" not strictly needed here.
+void mysql_yyerror(yyscan_t yyscanner, MysqlParser::ParserContext* parser_context, const char* msg);
+
+#endif // MYSQL_PARSER_INTERNAL_H
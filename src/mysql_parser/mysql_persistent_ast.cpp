@@ -0,0 +1,195 @@
+#include "mysql_parser/mysql_persistent_ast.h"
+#include <atomic>
+#include <utility>
+
+namespace MysqlParser {
+
+namespace {
+
+std::shared_ptr<PersistentNode> copy_node(const PersistentNode& node) {
+    auto copy = std::make_shared<PersistentNode>(node.type, node.value);
+    copy->children = node.children;
+    copy->escaped = node.escaped;
+    copy->symbol = node.symbol;
+    return copy;
+}
+
+} // namespace
+
+PersistentNode::~PersistentNode() {
+    if (children.empty()) return;
+    std::vector<PersistentNodePtr> pending;
+    pending.swap(children);
+    while (!pending.empty()) {
+        PersistentNodePtr node = std::move(pending.back());
+        pending.pop_back();
+        // Sole owner: nobody else can see the node, so take its children
+        // before it is destroyed at the end of this iteration. use_count() is
+        // a relaxed load; the fence pairs it with the acq_rel decrements of
+        // the owners that dropped their references on other threads, so their
+        // reads of the node happen before our writes to it. Nothing can raise
+        // the count again: there are no weak_ptrs to PersistentNodes and this
+        // is the only reference left.
+        if (node.use_count() == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            std::vector<PersistentNodePtr>& grandchildren = const_cast<PersistentNode&>(*node).children;
+            for (PersistentNodePtr& child : grandchildren) pending.push_back(std::move(child));
+            grandchildren.clear();
+        }
+    }
+}
+
+PersistentNodePtr make_persistent(const AstNode* root) {
+    if (!root) return nullptr;
+    auto copy_fields = [](const AstNode* node) {
+        auto copy = std::make_shared<PersistentNode>(node->type, node->value);
+        copy->escaped = node->escaped;
+        copy->symbol = node->symbol;
+        copy->children.reserve(node->children.size());
+        return copy;
+    };
+    std::shared_ptr<PersistentNode> result = copy_fields(root);
+    // Nodes are filled in while still private to this function
+    std::vector<std::pair<const AstNode*, PersistentNode*>> stack{{root, result.get()}};
+    while (!stack.empty()) {
+        auto [source, copy] = stack.back();
+        stack.pop_back();
+        for (const AstNode* child : source->children) {
+            if (!child) continue;
+            std::shared_ptr<PersistentNode> child_copy = copy_fields(child);
+            stack.emplace_back(child, child_copy.get());
+            copy->children.push_back(std::move(child_copy));
+        }
+    }
+    return result;
+}
+
+std::unique_ptr<AstNode> materialize_ast(const PersistentNode* root) {
+    if (!root) return nullptr;
+    auto copy_fields = [](const PersistentNode* node) {
+        AstNode* copy = new AstNode(node->type, node->value);
+        copy->escaped = node->escaped;
+        copy->symbol = node->symbol;
+        copy->children.reserve(node->children.size());
+        return copy;
+    };
+    std::unique_ptr<AstNode> result(copy_fields(root));
+    std::vector<std::pair<const PersistentNode*, AstNode*>> stack{{root, result.get()}};
+    while (!stack.empty()) {
+        auto [source, copy] = stack.back();
+        stack.pop_back();
+        for (const PersistentNodePtr& child : source->children) {
+            AstNode* child_copy = copy_fields(child.get());
+            copy->children.push_back(child_copy);
+            stack.emplace_back(child.get(), child_copy);
+        }
+    }
+    return result;
+}
+
+PersistentNodePtr with_value(const PersistentNode& node, std::string value) {
+    std::shared_ptr<PersistentNode> copy = copy_node(node);
+    copy->value = std::move(value);
+    return copy;
+}
+
+PersistentNodePtr with_child(const PersistentNode& node, size_t i, PersistentNodePtr child) {
+    if (i >= node.children.size() || !child) return nullptr;
+    std::shared_ptr<PersistentNode> copy = copy_node(node);
+    copy->children[i] = std::move(child);
+    return copy;
+}
+
+PersistentNodePtr with_inserted_child(const PersistentNode& node, size_t i, PersistentNodePtr child) {
+    if (i > node.children.size() || !child) return nullptr;
+    auto copy = std::make_shared<PersistentNode>(node.type, node.value);
+    copy->escaped = node.escaped;
+    copy->symbol = node.symbol;
+    copy->children.reserve(node.children.size() + 1);
+    copy->children.insert(copy->children.end(), node.children.begin(), node.children.begin() + i);
+    copy->children.push_back(std::move(child));
+    copy->children.insert(copy->children.end(), node.children.begin() + i, node.children.end());
+    return copy;
+}
+
+PersistentNodePtr without_child(const PersistentNode& node, size_t i) {
+    if (i >= node.children.size()) return nullptr;
+    std::shared_ptr<PersistentNode> copy = copy_node(node);
+    copy->children.erase(copy->children.begin() + i);
+    return copy;
+}
+
+PersistentNodePtr replace_at(const PersistentNodePtr& root, const AstPath& path, PersistentNodePtr replacement) {
+    if (!root || !replacement) return nullptr;
+    std::vector<const PersistentNode*> ancestors;
+    ancestors.reserve(path.size());
+    const PersistentNode* node = root.get();
+    for (uint32_t i : path) {
+        if (i >= node->children.size()) return nullptr;
+        ancestors.push_back(node);
+        node = node->children[i].get();
+    }
+    PersistentNodePtr current = std::move(replacement);
+    for (size_t level = path.size(); level-- > 0;) {
+        current = with_child(*ancestors[level], path[level], std::move(current));
+    }
+    return current;
+}
+
+const PersistentNode* node_at(const PersistentNode* root, const AstPath& path) {
+    const PersistentNode* node = root;
+    for (uint32_t i : path) {
+        if (!node || i >= node->children.size()) return nullptr;
+        node = node->children[i].get();
+    }
+    return node;
+}
+
+bool find_path(const PersistentNode* root, NodeType type, AstPath* path) {
+    return find_path(root, [type](const PersistentNode& node) { return node.type == type; }, path);
+}
+
+bool find_path(const PersistentNode* root, const std::function<bool(const PersistentNode&)>& match, AstPath* path) {
+    if (!root) return false;
+    if (match(*root)) {
+        path->clear();
+        return true;
+    }
+    // current holds the child index of every frame but the root's
+    std::vector<std::pair<const PersistentNode*, uint32_t>> stack{{root, 0}};
+    AstPath current;
+    while (!stack.empty()) {
+        const PersistentNode* node = stack.back().first;
+        uint32_t i = stack.back().second++;
+        if (i == node->children.size()) {
+            stack.pop_back();
+            if (!current.empty()) current.pop_back();
+            continue;
+        }
+        const PersistentNode* child = node->children[i].get();
+        current.push_back(i);
+        if (match(*child)) {
+            *path = std::move(current);
+            return true;
+        }
+        stack.emplace_back(child, 0);
+    }
+    return false;
+}
+
+bool same_tree(const PersistentNode* a, const PersistentNode* b) {
+    std::vector<std::pair<const PersistentNode*, const PersistentNode*>> stack{{a, b}};
+    while (!stack.empty()) {
+        auto [x, y] = stack.back();
+        stack.pop_back();
+        if (x == y) continue; // Shared subtree, or both null
+        if (!x || !y || x->type != y->type || x->value != y->value || x->escaped != y->escaped ||
+            x->symbol != y->symbol || x->children.size() != y->children.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < x->children.size(); ++i) stack.emplace_back(x->children[i].get(), y->children[i].get());
+    }
+    return true;
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,94 @@
+#include "mysql_parser/mysql_query_comments.h"
+#include "mysql_parser_internal.h"
+
+namespace MysqlParser {
+
+namespace {
+
+inline bool is_separator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ';';
+}
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool is_key_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '-';
+}
+
+inline char ascii_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (ascii_lower(a[i]) != ascii_lower(b[i])) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool QueryComments::hasHints() const {
+    for (const CommentSpan& c : comments) {
+        if (c.kind == CommentKind::Hint) return true;
+    }
+    return false;
+}
+
+const CommentAnnotation* QueryComments::findAnnotation(std::string_view sql, std::string_view key) const {
+    for (size_t i = annotations.size(); i-- > 0;) {
+        if (equals_ignore_case(annotations[i].key(sql), key)) return &annotations[i];
+    }
+    return nullptr;
+}
+
+void parse_comment_annotations(const char* body, size_t length, size_t body_offset, QueryComments& out) {
+    const char* p = body;
+    const char* end = body + length;
+    while (p < end) {
+        while (p < end && is_separator(*p)) ++p;
+        const char* key = p;
+        while (p < end && is_key_char(*p)) ++p;
+        const char* key_end = p;
+        while (p < end && is_blank(*p)) ++p;
+        if (key == key_end || p == end || *p != '=') {
+            // Not an annotation. After a bare word and blanks p is already at
+            // the next word, which may be one; otherwise skip the rest of this word.
+            if (key == key_end || p == key_end) {
+                while (p < end && !is_separator(*p)) ++p;
+            }
+            continue;
+        }
+        ++p; // '='
+        while (p < end && is_blank(*p)) ++p;
+        const char* value = p;
+        const char* value_end;
+        if (p < end && (*p == '\'' || *p == '"')) {
+            char quote = *p++;
+            value = p;
+            while (p < end && *p != quote) ++p;
+            value_end = p;
+            if (p < end) ++p;
+        } else {
+            while (p < end && !is_separator(*p)) ++p;
+            value_end = p;
+        }
+        out.annotations.push_back(CommentAnnotation{
+            static_cast<uint32_t>(body_offset + (key - body)), static_cast<uint32_t>(key_end - key),
+            static_cast<uint32_t>(body_offset + (value - body)), static_cast<uint32_t>(value_end - value)});
+    }
+}
+
+// --- Recording from the lexer (ParserContext) ---
+
+void ParserContext::internal_record_comment(CommentKind kind, const char* body, size_t length, size_t offset) {
+    comments_.comments.push_back(CommentSpan{static_cast<uint32_t>(offset), static_cast<uint32_t>(length), kind});
+    if (kind == CommentKind::Block || kind == CommentKind::Line) {
+        parse_comment_annotations(body, length, offset, comments_);
+    }
+}
+
+} // namespace MysqlParser
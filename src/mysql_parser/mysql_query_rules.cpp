@@ -0,0 +1,235 @@
+#include "mysql_parser/mysql_query_rules.h"
+#include "mysql_parser/mysql_ast_visitor.h"
+#include "mysql_parser/mysql_statement.h"
+#include <cctype>
+
+namespace MysqlParser {
+
+namespace {
+
+std::string to_lower(const std::string& s) {
+    std::string out(s);
+    for (char& c : out) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return out;
+}
+
+// a is compared case-insensitively with an already lower-cased b
+bool equals_lower(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != static_cast<unsigned char>(b[i])) return false;
+    }
+    return true;
+}
+
+// Collects table and system variable names anywhere in the tree
+struct FeatureCollector : AstVisitor<FeatureCollector> {
+    QueryFeatures* features = nullptr;
+
+    void add_table_name(const AstNode& name) {
+        if (name.type == NodeType::NODE_IDENTIFIER) {
+            features->tables.push_back(to_lower(name.value));
+        } else if (name.type == NodeType::NODE_QUALIFIED_IDENTIFIER) {
+            features->tables.push_back(to_lower(name.value));
+            if (!name.children.empty() && name.children.back()) {
+                features->tables.push_back(to_lower(name.children.back()->value));
+            }
+        }
+    }
+
+    // Table names sit in the first child of these nodes
+    VisitAction table_holder(const AstNode& node) {
+        if (!node.children.empty() && node.children[0]) add_table_name(*node.children[0]);
+        return VisitAction::Continue;
+    }
+
+    VisitAction visit(NodeTag<NodeType::NODE_TABLE_REFERENCE>, const AstNode& node) { return table_holder(node); }
+    VisitAction visit(NodeTag<NodeType::NODE_TABLE_SPECIFICATION>, const AstNode& node) { return table_holder(node); }
+    VisitAction visit(NodeTag<NodeType::NODE_INSERT_STATEMENT>, const AstNode& node) { return table_holder(node); }
+    VisitAction visit(NodeTag<NodeType::NODE_DELETE_STATEMENT>, const AstNode& node) {
+        // Single-table form; the multi-table forms' tables are TABLE_REFERENCEs
+        if (const AstNode* table = statement_of(&node).del.table) add_table_name(*table);
+        return VisitAction::Continue;
+    }
+    VisitAction visit(NodeTag<NodeType::NODE_SYSTEM_VARIABLE>, const AstNode& node) {
+        features->system_variables.push_back(to_lower(node.value));
+        return VisitAction::Continue;
+    }
+};
+
+} // namespace
+
+void QueryFeatures::clear() {
+    statement = NodeType::NODE_UNKNOWN;
+    tables.clear();
+    system_variables.clear();
+    for_update = false;
+    for_share = false;
+    has_limit = false;
+}
+
+void extract_query_features(const AstNode* root, QueryFeatures& features) {
+    features.clear();
+    if (!root) return;
+    features.statement = root->type;
+
+    FeatureCollector collector;
+    collector.features = &features;
+    collector.walk(root);
+
+    // LIMIT and locking only count on the statement itself, not in subqueries
+    const AstNode* limit = find_child(root, NodeType::NODE_LIMIT_CLAUSE);
+    features.has_limit = limit && !limit->children.empty();
+    if (const AstNode* locks = find_child(root, NodeType::NODE_LOCKING_CLAUSE_LIST)) {
+        for (const AstNode* clause : locks->children) {
+            const AstNode* strength = find_child(clause, NodeType::NODE_LOCK_STRENGTH);
+            if (!strength) continue;
+            if (strength->value == "UPDATE") features.for_update = true;
+            else if (strength->value == "SHARE") features.for_share = true;
+        }
+    }
+}
+
+bool QueryRule::matches(const QueryFeatures& features) const {
+    if (statement != NodeType::NODE_UNKNOWN && statement != features.statement) return false;
+
+    switch (lock) {
+        case LockMatch::Any: break;
+        case LockMatch::None: if (features.for_update || features.for_share) return false; break;
+        case LockMatch::ForUpdate: if (!features.for_update) return false; break;
+        case LockMatch::ForShare: if (!features.for_share) return false; break;
+        case LockMatch::Locking: if (!features.for_update && !features.for_share) return false; break;
+    }
+    if (limit == LimitMatch::Present && !features.has_limit) return false;
+    if (limit == LimitMatch::Absent && features.has_limit) return false;
+
+    auto any_of = [](const std::vector<std::string>& wanted, const std::vector<std::string>& present) {
+        if (wanted.empty()) return true;
+        for (const std::string& w : wanted) {
+            for (const std::string& p : present) {
+                if (equals_lower(w, p)) return true;
+            }
+        }
+        return false;
+    };
+    return any_of(tables, features.tables) && any_of(system_variables, features.system_variables);
+}
+
+bool RuleMatchSet::empty() const {
+    for (uint64_t word : bits_) {
+        if (word) return false;
+    }
+    return true;
+}
+
+long RuleMatchSet::first() const {
+    for (size_t w = 0; w < bits_.size(); ++w) {
+        if (bits_[w]) return static_cast<long>(w * 64 + __builtin_ctzll(bits_[w]));
+    }
+    return -1;
+}
+
+std::vector<size_t> RuleMatchSet::indices() const {
+    std::vector<size_t> out;
+    for (size_t w = 0; w < bits_.size(); ++w) {
+        uint64_t word = bits_[w];
+        while (word) {
+            out.push_back(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    return out;
+}
+
+size_t QueryRuleSet::addRule(QueryRule rule) {
+    for (std::string& t : rule.tables) t = to_lower(t);
+    for (std::string& v : rule.system_variables) v = to_lower(v);
+    rules_.push_back(std::move(rule));
+    compiled_ = false;
+    return rules_.size() - 1;
+}
+
+void QueryRuleSet::compile() {
+    words_ = (rules_.size() + 63) / 64;
+    auto fresh = [this]() { return Bitset(words_, 0); };
+    for (Bitset& mask : statement_masks_) mask = fresh();
+    for (Bitset& mask : lock_masks_) mask = fresh();
+    for (Bitset& mask : limit_masks_) mask = fresh();
+    any_table_mask_ = fresh();
+    any_variable_mask_ = fresh();
+    table_postings_.clear();
+    variable_postings_.clear();
+
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        const QueryRule& rule = rules_[i];
+        const size_t w = i / 64;
+        const uint64_t bit = uint64_t(1) << (i % 64);
+
+        for (size_t t = 0; t < kNodeTypeCount; ++t) {
+            if (rule.statement == NodeType::NODE_UNKNOWN || static_cast<size_t>(rule.statement) == t) {
+                statement_masks_[t][w] |= bit;
+            }
+        }
+        for (size_t state = 0; state < lock_masks_.size(); ++state) {
+            QueryFeatures probe;
+            probe.for_update = state & 1;
+            probe.for_share = state & 2;
+            QueryRule lock_only;
+            lock_only.lock = rule.lock;
+            if (lock_only.matches(probe)) lock_masks_[state][w] |= bit;
+        }
+        if (rule.limit != LimitMatch::Present) limit_masks_[0][w] |= bit;
+        if (rule.limit != LimitMatch::Absent) limit_masks_[1][w] |= bit;
+
+        if (rule.tables.empty()) any_table_mask_[w] |= bit;
+        for (const std::string& t : rule.tables) table_postings_[t].push_back(static_cast<uint32_t>(i));
+        if (rule.system_variables.empty()) any_variable_mask_[w] |= bit;
+        for (const std::string& v : rule.system_variables) variable_postings_[v].push_back(static_cast<uint32_t>(i));
+    }
+    compiled_ = true;
+}
+
+void QueryRuleSet::or_postings(const Postings& postings, const std::vector<std::string>& keys, Bitset& out) {
+    for (const std::string& key : keys) {
+        auto it = postings.find(key);
+        if (it == postings.end()) continue;
+        for (uint32_t i : it->second) out[i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+void QueryRuleSet::match(const QueryFeatures& features, RuleMatchSet& out) const {
+    if (!compiled_) {
+        out.bits_.clear();
+        return;
+    }
+    const Bitset& stmt = statement_masks_[static_cast<size_t>(features.statement) < kNodeTypeCount
+                                             ? static_cast<size_t>(features.statement) : 0];
+    const Bitset& lock = lock_masks_[(features.for_update ? 1 : 0) | (features.for_share ? 2 : 0)];
+    const Bitset& limit = limit_masks_[features.has_limit ? 1 : 0];
+
+    out.bits_.resize(words_);
+    bool any = false;
+    for (size_t w = 0; w < words_; ++w) {
+        out.bits_[w] = stmt[w] & lock[w] & limit[w];
+        any |= out.bits_[w] != 0;
+    }
+    if (!any) return;
+
+    // Table and variable conditions: wildcard rules plus the posting lists of the names present
+    out.scratch_ = any_table_mask_;
+    or_postings(table_postings_, features.tables, out.scratch_);
+    for (size_t w = 0; w < words_; ++w) out.bits_[w] &= out.scratch_[w];
+
+    out.scratch_ = any_variable_mask_;
+    or_postings(variable_postings_, features.system_variables, out.scratch_);
+    for (size_t w = 0; w < words_; ++w) out.bits_[w] &= out.scratch_[w];
+}
+
+const QueryRule* QueryRuleSet::matchFirst(const QueryFeatures& features) const {
+    RuleMatchSet matches;
+    match(features, matches);
+    long first = matches.first();
+    return first < 0 ? nullptr : &rules_[static_cast<size_t>(first)];
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,254 @@
+#include "mysql_parser/mysql_session_state.h"
+#include "mysql_parser/mysql_ast_print.h" // For node_type_name
+#include "mysql_parser_internal.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace MysqlParser {
+
+namespace {
+
+struct VariableNameTable {
+    std::mutex mutex;
+    std::unordered_map<std::string, VariableId> ids;
+    std::vector<const std::string*> names; // Points at the keys of ids
+};
+
+VariableNameTable& name_table() {
+    static VariableNameTable* table = new VariableNameTable(); // Never destroyed: parsers may outlive statics
+    return *table;
+}
+
+uint64_t mix64(uint64_t x) { // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t key_of(VariableScope scope, VariableId id) {
+    return (static_cast<uint64_t>(scope) << 32) | id;
+}
+
+// Contribution of one entry to the state hash; entries are summed so order does not matter
+uint64_t entry_hash(const SessionVariable& v) {
+    return mix64(key_of(v.scope, v.id) ^ mix64(v.value_hash));
+}
+
+bool key_less(const SessionVariable& v, uint64_t key) {
+    return key_of(v.scope, v.id) < key;
+}
+
+void append_upper(std::string& out, const std::string& s) {
+    for (char c : s) out += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+}
+
+void format_value(std::string& out, const AstNode* node) {
+    if (!node) return;
+    switch (node->type) {
+        case NodeType::NODE_NUMBER_LITERAL:
+        case NodeType::NODE_STRING_LITERAL:
+            out += node->value;
+            return;
+        case NodeType::NODE_IDENTIFIER:
+        case NodeType::NODE_KEYWORD:
+            append_upper(out, node->value);
+            return;
+        default:
+            break;
+    }
+    const char* name = node_type_name(node->type);
+    out += name ? name : "NODE";
+    out += '(';
+    out += node->value;
+    for (const AstNode* child : node->children) {
+        out += ',';
+        format_value(out, child);
+    }
+    out += ')';
+}
+
+} // namespace
+
+VariableId intern_variable_name(const std::string& name) {
+    std::string lower(name);
+    for (char& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    VariableNameTable& table = name_table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto it = table.ids.find(lower);
+    if (it != table.ids.end()) return it->second;
+    VariableId id = static_cast<VariableId>(table.names.size());
+    auto inserted = table.ids.emplace(std::move(lower), id).first;
+    table.names.push_back(&inserted->first);
+    return id;
+}
+
+std::string variable_name(VariableId id) {
+    VariableNameTable& table = name_table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return id < table.names.size() ? *table.names[id] : std::string();
+}
+
+std::string format_session_value(const AstNode* value) {
+    std::string out;
+    format_value(out, value);
+    return out;
+}
+
+void SessionState::set(VariableScope scope, VariableId id, std::string value) {
+    uint64_t key = key_of(scope, id);
+    auto it = std::lower_bound(variables_.begin(), variables_.end(), key, key_less);
+    uint64_t value_hash = std::hash<std::string>()(value);
+    if (it != variables_.end() && key_of(it->scope, it->id) == key) {
+        hash_ -= entry_hash(*it);
+        it->value = std::move(value);
+        it->value_hash = value_hash;
+    } else {
+        it = variables_.insert(it, SessionVariable{scope, id, std::move(value), value_hash});
+    }
+    hash_ += entry_hash(*it);
+}
+
+void SessionState::set(VariableScope scope, const std::string& name, std::string value) {
+    set(scope, intern_variable_name(name), std::move(value));
+}
+
+bool SessionState::erase(VariableScope scope, VariableId id) {
+    uint64_t key = key_of(scope, id);
+    auto it = std::lower_bound(variables_.begin(), variables_.end(), key, key_less);
+    if (it == variables_.end() || key_of(it->scope, it->id) != key) return false;
+    hash_ -= entry_hash(*it);
+    variables_.erase(it);
+    return true;
+}
+
+void SessionState::clear() {
+    variables_.clear();
+    hash_ = 0;
+}
+
+void SessionState::endTransaction() {
+    auto first = std::remove_if(variables_.begin(), variables_.end(), [this](const SessionVariable& v) {
+        if (v.scope != VariableScope::NextTransaction) return false;
+        hash_ -= entry_hash(v);
+        return true;
+    });
+    variables_.erase(first, variables_.end());
+}
+
+const SessionVariable* SessionState::find(VariableScope scope, VariableId id) const {
+    uint64_t key = key_of(scope, id);
+    auto it = std::lower_bound(variables_.begin(), variables_.end(), key, key_less);
+    if (it == variables_.end() || key_of(it->scope, it->id) != key) return nullptr;
+    return &*it;
+}
+
+SessionStateDiff SessionState::diff(const SessionState& target) const {
+    SessionStateDiff out;
+    auto a = variables_.begin();
+    auto b = target.variables_.begin();
+    while (a != variables_.end() || b != target.variables_.end()) {
+        if (b == target.variables_.end() || (a != variables_.end() && key_of(a->scope, a->id) < key_of(b->scope, b->id))) {
+            out.removed.push_back(*a++);
+        } else if (a == variables_.end() || key_of(b->scope, b->id) < key_of(a->scope, a->id)) {
+            out.changed.push_back(*b++);
+        } else {
+            if (a->value_hash != b->value_hash || a->value != b->value) out.changed.push_back(*b);
+            ++a;
+            ++b;
+        }
+    }
+    return out;
+}
+
+bool SessionState::operator==(const SessionState& other) const {
+    if (hash_ != other.hash_ || variables_.size() != other.variables_.size()) return false;
+    for (size_t i = 0; i < variables_.size(); ++i) {
+        const SessionVariable& a = variables_[i];
+        const SessionVariable& b = other.variables_[i];
+        if (a.scope != b.scope || a.id != b.id || a.value_hash != b.value_hash || a.value != b.value) return false;
+    }
+    return true;
+}
+
+// --- Recording from the grammar (ParserContext) ---
+
+namespace {
+
+// Ids of the variables implied by SET NAMES / SET CHARACTER SET / SET TRANSACTION
+struct ImpliedVariables {
+    VariableId character_set_client = intern_variable_name("character_set_client");
+    VariableId character_set_connection = intern_variable_name("character_set_connection");
+    VariableId character_set_results = intern_variable_name("character_set_results");
+    VariableId collation_connection = intern_variable_name("collation_connection");
+    VariableId transaction_isolation = intern_variable_name("transaction_isolation");
+};
+
+const ImpliedVariables& implied() {
+    static const ImpliedVariables ids;
+    return ids;
+}
+
+} // namespace
+
+void ParserContext::internal_record_assignment(const AstNode* variable, const AstNode* value) {
+    if (!session_state_ || !variable) return;
+    VariableScope scope = VariableScope::Session;
+    if (variable->type == NodeType::NODE_USER_VARIABLE) {
+        scope = VariableScope::User;
+    } else if (variable->type == NodeType::NODE_SYSTEM_VARIABLE) {
+        for (const AstNode* child : variable->children) {
+            if (child->type == NodeType::NODE_VARIABLE_SCOPE && child->value != "SESSION") return; // GLOBAL, PERSIST...
+        }
+    } else {
+        return;
+    }
+    bool reset = value && value->type == NodeType::NODE_KEYWORD && value->value == "DEFAULT";
+    pending_session_changes_.push_back(
+        {SessionVariable{scope, intern_variable_name(variable->value), reset ? std::string() : format_session_value(value), 0}, reset});
+}
+
+void ParserContext::internal_record_set_names(const AstNode* charset, const AstNode* collation) {
+    if (!session_state_) return;
+    std::string value = format_session_value(charset);
+    pending_session_changes_.push_back({SessionVariable{VariableScope::Session, implied().character_set_client, value, 0}, false});
+    pending_session_changes_.push_back({SessionVariable{VariableScope::Session, implied().character_set_connection, value, 0}, false});
+    pending_session_changes_.push_back({SessionVariable{VariableScope::Session, implied().character_set_results, value, 0}, false});
+    // Without COLLATE the server picks the charset's default collation
+    pending_session_changes_.push_back({SessionVariable{VariableScope::Session, implied().collation_connection,
+                                                       collation ? format_session_value(collation) : "DEFAULT", 0}, false});
+}
+
+void ParserContext::internal_record_set_charset(const AstNode* charset) {
+    if (!session_state_) return;
+    std::string value = format_session_value(charset);
+    pending_session_changes_.push_back({SessionVariable{VariableScope::Session, implied().character_set_client, value, 0}, false});
+    pending_session_changes_.push_back({SessionVariable{VariableScope::Session, implied().character_set_results, value, 0}, false});
+    // SET CHARACTER SET takes the connection charset from @@character_set_database
+    pending_session_changes_.push_back({SessionVariable{VariableScope::Session, implied().character_set_connection,
+                                                       "@@CHARACTER_SET_DATABASE", 0}, false});
+}
+
+void ParserContext::internal_record_transaction(const AstNode* characteristics, const char* scope) {
+    if (!session_state_ || !characteristics) return;
+    VariableScope target = VariableScope::NextTransaction;
+    if (scope) {
+        if (std::string(scope) != "SESSION") return;
+        target = VariableScope::Session;
+    }
+    for (const AstNode* characteristic : characteristics->children) {
+        if (characteristic->type != NodeType::NODE_TXN_ISOLATION_LEVEL || characteristic->children.empty()) continue;
+        // Same spelling as the transaction_isolation variable: READ-COMMITTED
+        std::string level = format_session_value(characteristic->children[0]);
+        std::replace(level.begin(), level.end(), ' ', '-');
+        pending_session_changes_.push_back({SessionVariable{target, implied().transaction_isolation, std::move(level), 0}, false});
+    }
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,338 @@
+#include "mysql_parser/mysql_shard_keys.h"
+#include <cctype>
+#include <cstdlib>
+
+namespace MysqlParser {
+
+namespace {
+
+std::string to_lower(std::string s) {
+    for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+// a is compared case-insensitively with an already lower-cased b
+bool equals_lower(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != static_cast<unsigned char>(b[i])) return false;
+    }
+    return true;
+}
+
+bool equals_nocase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+// A literal, or a number literal under unary minus
+bool constant_of(const AstNode* node, ShardValue& out) {
+    if (!node) return false;
+    if (node->type == NodeType::NODE_NUMBER_LITERAL || node->type == NodeType::NODE_STRING_LITERAL) {
+        out = ShardValue{node, false};
+        return true;
+    }
+    if (node->type == NodeType::NODE_OPERATOR && node->value == "-" && node->children.size() == 1 &&
+        node->children[0] && node->children[0]->type == NodeType::NODE_NUMBER_LITERAL) {
+        out = ShardValue{node->children[0], true};
+        return true;
+    }
+    return false;
+}
+
+bool same_value(const ShardValue& a, const ShardValue& b) {
+    return a.literal->type == b.literal->type && a.negative == b.negative && a.literal->value == b.literal->value;
+}
+
+// Only when both are numbers; strict, so that rounding never picks the looser bound
+bool less_number(const ShardValue& a, const ShardValue& b) {
+    if (a.isString() || b.isString()) return false;
+    double x = std::strtod(a.literal->value.c_str(), nullptr), y = std::strtod(b.literal->value.c_str(), nullptr);
+    return (a.negative ? -x : x) < (b.negative ? -y : y);
+}
+
+// col <op> constant, as seen from the column
+enum class Bound { None, Lower, LowerInclusive, Upper, UpperInclusive };
+
+Bound bound_of(const std::string& op, bool column_on_left) {
+    if (op == "<") return column_on_left ? Bound::Upper : Bound::Lower;
+    if (op == "<=") return column_on_left ? Bound::UpperInclusive : Bound::LowerInclusive;
+    if (op == ">") return column_on_left ? Bound::Lower : Bound::Upper;
+    if (op == ">=") return column_on_left ? Bound::LowerInclusive : Bound::UpperInclusive;
+    return Bound::None;
+}
+
+bool is_column(const AstNode* node) {
+    return node && (node->type == NodeType::NODE_IDENTIFIER ||
+                    (node->type == NodeType::NODE_QUALIFIED_IDENTIFIER && node->children.size() == 2));
+}
+
+// One extract() call. The constraints of a SELECT's (or DELETE's) tables are
+// contiguous in out, from scope_begin to the end, while its WHERE clause is
+// applied to them.
+class ShardKeyExtractor {
+public:
+    ShardKeyExtractor(const ShardKeySet& keys, ShardRouting& out) : keys_(keys), out_(out) {}
+
+    void statement(const Statement& s) {
+        switch (s.kind) {
+            case StatementKind::Select:
+                query(s.select.from, s.select.where);
+                break;
+            case StatementKind::Delete:
+                if (s.del.table) {
+                    size_t scope_begin = out_.constraint_count;
+                    add_table(s.del.table, std::string_view());
+                    where(s.del.where, scope_begin);
+                } else {
+                    // The targets are names from FROM or USING, which hold the tables
+                    query(s.del.from ? s.del.from : s.del.using_tables, s.del.where);
+                }
+                break;
+            case StatementKind::Insert:
+                insert(s.insert);
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    void query(const AstNode* tables, const AstNode* where_clause) {
+        size_t scope_begin = out_.constraint_count;
+        if (tables) add_tables(tables);
+        where(where_clause, scope_begin);
+        // Derived tables last, so that their constraints do not interleave
+        // with this scope's
+        if (tables) derived_tables(tables);
+    }
+
+    // Table references of a FROM or USING clause, through joins and parentheses
+    void add_tables(const AstNode* node) {
+        for (const AstNode* c : node->children) {
+            if (!c) continue;
+            if (c->type == NodeType::NODE_TABLE_REFERENCE) {
+                const AstNode* name = c->children.empty() ? nullptr : c->children[0];
+                if (name && (name->type == NodeType::NODE_IDENTIFIER || name->type == NodeType::NODE_QUALIFIED_IDENTIFIER)) {
+                    const AstNode* alias = c->children.size() > 1 ? c->children[1] : nullptr;
+                    add_table(name, alias && alias->type == NodeType::NODE_ALIAS ? std::string_view(alias->value) : std::string_view());
+                } else {
+                    add_tables(c); // (table_reference) [AS alias]
+                }
+            } else if (c->type == NodeType::NODE_JOIN_CLAUSE) {
+                add_tables(c);
+            }
+        }
+    }
+
+    void derived_tables(const AstNode* node) {
+        for (const AstNode* c : node->children) {
+            if (!c) continue;
+            if (c->type == NodeType::NODE_DERIVED_TABLE) {
+                const AstNode* subquery = c->children.empty() ? nullptr : c->children[0];
+                if (subquery && !subquery->children.empty()) {
+                    Statement inner = statement_of(subquery->children[0]);
+                    if (inner.kind == StatementKind::Select) query(inner.select.from, inner.select.where);
+                }
+            } else if (c->type == NodeType::NODE_TABLE_REFERENCE || c->type == NodeType::NODE_JOIN_CLAUSE) {
+                derived_tables(c);
+            }
+        }
+    }
+
+    // One constraint per shard key of the table
+    void add_table(const AstNode* name, std::string_view alias) {
+        std::string_view short_name = name->type == NodeType::NODE_QUALIFIED_IDENTIFIER && !name->children.empty()
+                                          ? std::string_view(name->children.back()->value) : std::string_view(name->value);
+        for (size_t k = 0; k < keys_.size(); ++k) {
+            const std::string& table = keys_.key(k).table;
+            if (!equals_lower(name->value, table) && !equals_lower(short_name, table)) continue;
+            if (out_.constraint_count == ShardRouting::kMaxConstraints) {
+                out_.truncated = true;
+                return;
+            }
+            ShardConstraint& c = out_.constraints[out_.constraint_count++];
+            c = ShardConstraint();
+            c.key = static_cast<uint16_t>(k);
+            c.table = name;
+            c.qualifier = alias.empty() ? short_name : alias;
+        }
+    }
+
+    void where(const AstNode* clause, size_t scope_begin) {
+        if (!clause || scope_begin == out_.constraint_count || clause->children.empty()) return;
+        conjuncts(clause->children[0], scope_begin);
+    }
+
+    // Left-deep AND chains are walked in a loop; only parenthesized ones on
+    // the right recurse
+    void conjuncts(const AstNode* node, size_t scope_begin) {
+        while (node && node->type == NodeType::NODE_LOGICAL_AND_EXPRESSION && node->children.size() == 2) {
+            conjuncts(node->children[1], scope_begin);
+            node = node->children[0];
+        }
+        if (node) predicate(node, scope_begin);
+    }
+
+    void predicate(const AstNode* node, size_t scope_begin) {
+        if (node->children.size() != 2) return;
+        const AstNode* left = node->children[0];
+        const AstNode* right = node->children[1];
+        if (node->type == NodeType::NODE_IN_EXPRESSION) {
+            if (node->value != "IN" || !is_column(left) || !right) return;
+            for (size_t i = scope_begin; i < out_.constraint_count; ++i) {
+                if (refers_to(left, out_.constraints[i])) bind_values(out_.constraints[i], right->children.data(), right->children.size());
+            }
+            return;
+        }
+        if (node->type != NodeType::NODE_COMPARISON_EXPRESSION) return;
+        ShardValue value;
+        bool column_on_left = is_column(left) && constant_of(right, value);
+        if (!column_on_left && !(is_column(right) && constant_of(left, value))) return;
+        const AstNode* column = column_on_left ? left : right;
+        Bound bound = node->value == "=" ? Bound::None : bound_of(node->value, column_on_left);
+        if (node->value != "=" && bound == Bound::None) return; // !=
+        for (size_t i = scope_begin; i < out_.constraint_count; ++i) {
+            ShardConstraint& c = out_.constraints[i];
+            if (!refers_to(column, c)) continue;
+            if (bound == Bound::None) {
+                const AstNode* operand = column_on_left ? right : left;
+                bind_values(c, &operand, 1);
+            } else {
+                bind_bound(c, bound, value);
+            }
+        }
+    }
+
+    bool refers_to(const AstNode* column, const ShardConstraint& c) const {
+        const std::string& key_column = keys_.key(c.key).column;
+        if (column->type == NodeType::NODE_IDENTIFIER) return equals_lower(column->value, key_column);
+        return equals_lower(column->children[1]->value, key_column) && equals_nocase(column->children[0]->value, c.qualifier);
+    }
+
+    // Binds the constraint to the operands, unless one of them is not a
+    // constant or it is already bound to no more values than these
+    void bind_values(ShardConstraint& c, const AstNode* const* operands, size_t count) {
+        if (c.has_values && c.value_count <= count) return;
+        size_t first = out_.value_count;
+        for (size_t i = 0; i < count; ++i) {
+            ShardValue value;
+            if (!constant_of(operands[i], value) || !append_value(first, value)) {
+                out_.value_count = first;
+                return;
+            }
+        }
+        commit_values(c, first);
+    }
+
+    // Appends value to the values from first on, unless it is among them;
+    // false when out of room
+    bool append_value(size_t first, const ShardValue& value) {
+        for (size_t j = first; j < out_.value_count; ++j) {
+            if (same_value(out_.values[j], value)) return true;
+        }
+        if (out_.value_count == ShardRouting::kMaxValues) {
+            out_.truncated = true;
+            return false;
+        }
+        out_.values[out_.value_count++] = value;
+        return true;
+    }
+
+    // The values from first on become the constraint's, if fewer than it has
+    void commit_values(ShardConstraint& c, size_t first) {
+        size_t count = out_.value_count - first;
+        if (c.has_values && c.value_count <= count) {
+            out_.value_count = first;
+            return;
+        }
+        c.has_values = true;
+        c.first_value = static_cast<uint16_t>(first);
+        c.value_count = static_cast<uint16_t>(count);
+    }
+
+    void bind_bound(ShardConstraint& c, Bound bound, const ShardValue& value) {
+        bool lower = bound == Bound::Lower || bound == Bound::LowerInclusive;
+        bool inclusive = bound == Bound::LowerInclusive || bound == Bound::UpperInclusive;
+        ShardBound& b = lower ? c.lower : c.upper;
+        if (b.value.literal) {
+            // Keep the tighter of two numeric bounds, else the first
+            if (same_value(b.value, value)) {
+                b.inclusive = b.inclusive && inclusive;
+                return;
+            }
+            if (!(lower ? less_number(b.value, value) : less_number(value, b.value))) return;
+        }
+        b.value = value;
+        b.inclusive = inclusive;
+    }
+
+    void insert(const InsertStmt& s) {
+        if (!s.table) return;
+        size_t scope_begin = out_.constraint_count;
+        add_table(s.table, std::string_view());
+        const AstNode* rows = s.values && !s.values->children.empty() ? s.values->children[0] : nullptr;
+        for (size_t i = scope_begin; i < out_.constraint_count && s.columns && rows; ++i) {
+            ShardConstraint& c = out_.constraints[i];
+            // Position of the key in the column list; without it, the rows
+            // take the column's default
+            size_t position = s.columns->children.size();
+            for (size_t p = 0; p < s.columns->children.size(); ++p) {
+                const AstNode* column = s.columns->children[p];
+                if (column && column->type == NodeType::NODE_IDENTIFIER && equals_lower(column->value, keys_.key(c.key).column)) {
+                    position = p;
+                    break;
+                }
+            }
+            if (position == s.columns->children.size()) continue;
+            size_t first = out_.value_count;
+            bool bound = true;
+            for (const AstNode* row : rows->children) {
+                ShardValue value;
+                bound = row && position < row->children.size() && constant_of(row->children[position], value) &&
+                        append_value(first, value);
+                if (!bound) break;
+            }
+            if (bound) {
+                commit_values(c, first);
+            } else {
+                out_.value_count = first;
+            }
+        }
+    }
+
+    const ShardKeySet& keys_;
+    ShardRouting& out_;
+};
+
+} // namespace
+
+void ShardRouting::clear() {
+    spans_all_shards = false;
+    truncated = false;
+    constraint_count = 0;
+    value_count = 0;
+}
+
+size_t ShardKeySet::addKey(std::string table, std::string column) {
+    keys_.push_back(ShardKey{to_lower(std::move(table)), to_lower(std::move(column))});
+    return keys_.size() - 1;
+}
+
+void ShardKeySet::extract(const Statement& statement, ShardRouting& out) const {
+    out.clear();
+    ShardKeyExtractor(*this, out).statement(statement);
+    out.spans_all_shards = out.truncated;
+    for (size_t i = 0; i < out.constraint_count; ++i) {
+        if (!out.constraints[i].has_values) out.spans_all_shards = true;
+    }
+}
+
+void ShardKeySet::extract(const AstNode* root, ShardRouting& out) const {
+    extract(statement_of(root), out);
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,126 @@
+#include "mysql_parser/mysql_statement.h"
+#include "mysql_parser_internal.h"
+
+namespace MysqlParser {
+
+namespace {
+
+// Trees built before clauses lost their placeholders may still have empty ones
+inline const AstNode* present(const AstNode* clause) {
+    return clause && !clause->children.empty() ? clause : nullptr;
+}
+
+void read_select(const AstNode* node, SelectStmt& s) {
+    for (const AstNode* c : node->children) {
+        if (!c) continue;
+        switch (c->type) {
+            case NodeType::NODE_SELECT_OPTIONS: s.options = present(c); break;
+            case NodeType::NODE_SELECT_ITEM_LIST: s.items = c; break;
+            case NodeType::NODE_INTO_OUTFILE:
+            case NodeType::NODE_INTO_DUMPFILE:
+            case NodeType::NODE_INTO_VAR_LIST: s.into = c; break;
+            case NodeType::NODE_FROM_CLAUSE: s.from = c; break;
+            case NodeType::NODE_WHERE_CLAUSE: s.where = present(c); break;
+            case NodeType::NODE_GROUP_BY_CLAUSE: s.group_by = present(c); break;
+            case NodeType::NODE_HAVING_CLAUSE: s.having = present(c); break;
+            case NodeType::NODE_ORDER_BY_CLAUSE: s.order_by = present(c); break;
+            case NodeType::NODE_LIMIT_CLAUSE: s.limit = present(c); break;
+            case NodeType::NODE_LOCKING_CLAUSE_LIST: s.locking = c; break;
+            default: break;
+        }
+    }
+}
+
+void read_insert(const AstNode* node, InsertStmt& s) {
+    for (const AstNode* c : node->children) {
+        if (!c) continue;
+        switch (c->type) {
+            case NodeType::NODE_IDENTIFIER:
+            case NodeType::NODE_QUALIFIED_IDENTIFIER: s.table = c; break;
+            case NodeType::NODE_COLUMN_LIST: s.columns = present(c); break;
+            case NodeType::NODE_VALUES_CLAUSE: s.values = c; break;
+            default: break;
+        }
+    }
+}
+
+void read_delete(const AstNode* node, DeleteStmt& s) {
+    for (const AstNode* c : node->children) {
+        if (!c) continue;
+        switch (c->type) {
+            case NodeType::NODE_DELETE_OPTIONS: s.options = present(c); break;
+            case NodeType::NODE_IDENTIFIER:
+            case NodeType::NODE_QUALIFIED_IDENTIFIER: s.table = c; break;
+            case NodeType::NODE_TABLE_NAME_LIST: s.targets = c; break;
+            case NodeType::NODE_FROM_CLAUSE: s.from = c; break;
+            case NodeType::NODE_USING_CLAUSE: s.using_tables = c; break;
+            case NodeType::NODE_WHERE_CLAUSE: s.where = present(c); break;
+            case NodeType::NODE_ORDER_BY_CLAUSE: s.order_by = present(c); break;
+            case NodeType::NODE_LIMIT_CLAUSE: s.limit = present(c); break;
+            default: break;
+        }
+    }
+}
+
+} // namespace
+
+Statement statement_of(const AstNode* node) {
+    Statement s;
+    if (!node) return s;
+    s.node = node;
+    switch (node->type) {
+        case NodeType::NODE_SELECT_STATEMENT:
+            s.kind = StatementKind::Select;
+            read_select(node, s.select);
+            break;
+        case NodeType::NODE_INSERT_STATEMENT:
+            s.kind = StatementKind::Insert;
+            read_insert(node, s.insert);
+            break;
+        case NodeType::NODE_DELETE_STATEMENT:
+            s.kind = StatementKind::Delete;
+            read_delete(node, s.del);
+            break;
+        case NodeType::NODE_SET_NAMES:
+            s.kind = StatementKind::Set;
+            s.set.names = node;
+            break;
+        case NodeType::NODE_SET_CHARSET:
+            s.kind = StatementKind::Set;
+            s.set.charset = node;
+            break;
+        case NodeType::NODE_SET_STATEMENT:
+            s.kind = StatementKind::Set;
+            for (const AstNode* c : node->children) {
+                if (c && c->type == NodeType::NODE_VARIABLE_ASSIGNMENT_LIST) s.set.assignments = c;
+                if (c && c->type == NodeType::NODE_TXN_CHARACTERISTIC_LIST) s.set.transaction = c;
+            }
+            break;
+        default:
+            s.kind = StatementKind::Other;
+            break;
+    }
+    return s;
+}
+
+// --- Recording from the grammar (ParserContext) ---
+
+void ParserContext::internal_set_statement(StatementKind kind, AstNode* root) {
+    MYSQL_TRACE2(statement, static_cast<int>(kind), root ? static_cast<int>(root->type) : -1);
+    internal_set_ast(root);
+    // The grammar filled in the member for kind; members for other kinds may
+    // hold a subquery's clauses and are cleared
+    Statement typed;
+    typed.kind = kind;
+    typed.node = root;
+    switch (kind) {
+        case StatementKind::Select: typed.select = statement_.select; break;
+        case StatementKind::Insert: typed.insert = statement_.insert; break;
+        case StatementKind::Delete: typed.del = statement_.del; break;
+        case StatementKind::Set: typed.set = statement_.set; break;
+        default: break;
+    }
+    statement_ = typed;
+}
+
+} // namespace MysqlParser
@@ -0,0 +1,125 @@
+#include "mysql_parser/mysql_symbol_table.h"
+#include "mysql_parser_internal.h"
+#include <mutex>
+
+namespace MysqlParser {
+
+namespace {
+
+inline bool has_upper(std::string_view s) {
+    for (char c : s) {
+        if (c >= 'A' && c <= 'Z') return true;
+    }
+    return false;
+}
+
+std::string ascii_lower(std::string_view s) {
+    std::string out(s);
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return out;
+}
+
+} // namespace
+
+SymbolTable::SymbolTable(const SymbolTableOptions& options) : options_(options) {
+    if (options_.max_symbols > UINT32_MAX - 1) options_.max_symbols = UINT32_MAX - 1;
+    size_t chunk_count = (options_.max_symbols >> kChunkBits) + 1;
+    chunks_.reset(new std::atomic<Entry*>[chunk_count]);
+    for (size_t i = 0; i < chunk_count; ++i) chunks_[i].store(nullptr, std::memory_order_relaxed);
+}
+
+SymbolTable::~SymbolTable() {
+    size_t chunk_count = (options_.max_symbols >> kChunkBits) + 1;
+    for (size_t i = 0; i < chunk_count; ++i) delete[] chunks_[i].load(std::memory_order_relaxed);
+}
+
+uint64_t SymbolTable::hash_name(std::string_view name) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : name) h = (h ^ c) * 0x100000001b3ULL;
+    return h;
+}
+
+SymbolTable::Entry& SymbolTable::entry(Symbol symbol) const {
+    size_t index = symbol - 1;
+    Entry* chunk = chunks_[index >> kChunkBits].load(std::memory_order_acquire);
+    return chunk[index & ((size_t(1) << kChunkBits) - 1)];
+}
+
+Symbol SymbolTable::intern(std::string_view name) {
+    return intern(name, hash_name(name));
+}
+
+Symbol SymbolTable::intern(std::string_view name, uint64_t hash) {
+    Shard& shard = shards_[hash % kShards];
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.symbols.find(name);
+        if (it != shard.symbols.end()) return it->second;
+    }
+    // New name. Its lower-cased form is interned first, outside this shard's
+    // lock; if that does not fit, neither does name, which would otherwise
+    // become its own folded symbol.
+    Symbol folded = kNoSymbol;
+    if (has_upper(name)) {
+        folded = intern(ascii_lower(name));
+        if (folded == kNoSymbol) return kNoSymbol;
+    }
+    return insert(shard, name, folded);
+}
+
+Symbol SymbolTable::insert(Shard& shard, std::string_view name, Symbol folded) {
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.symbols.find(name);
+    if (it != shard.symbols.end()) return it->second; // Added while we were unlocked
+
+    size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= options_.max_symbols) {
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return kNoSymbol;
+    }
+    std::atomic<Entry*>& slot = chunks_[index >> kChunkBits];
+    if (!slot.load(std::memory_order_acquire)) {
+        // Another shard may be allocating the same chunk
+        Entry* chunk = new Entry[size_t(1) << kChunkBits];
+        Entry* expected = nullptr;
+        if (!slot.compare_exchange_strong(expected, chunk, std::memory_order_acq_rel)) delete[] chunk;
+    }
+    Symbol symbol = static_cast<Symbol>(index + 1);
+    Entry& e = entry(symbol);
+    e.text.assign(name.data(), name.size());
+    e.folded = folded ? folded : symbol;
+    shard.symbols.emplace(std::string_view(e.text), symbol);
+    return symbol;
+}
+
+Symbol SymbolTable::find(std::string_view name) const {
+    const Shard& shard = shards_[hash_name(name) % kShards];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.symbols.find(name);
+    return it == shard.symbols.end() ? kNoSymbol : it->second;
+}
+
+std::string_view SymbolTable::name(Symbol symbol) const {
+    if (symbol == kNoSymbol || symbol > size()) return std::string_view();
+    return entry(symbol).text;
+}
+
+Symbol SymbolTable::folded(Symbol symbol) const {
+    if (symbol == kNoSymbol || symbol > size()) return kNoSymbol;
+    return entry(symbol).folded;
+}
+
+// --- Lookups from the grammar (ParserContext) ---
+
+Symbol ParserContext::intern_cached(const std::string& name) {
+    uint64_t hash = SymbolTable::hash_name(name);
+    SymbolCacheEntry& cached = symbol_cache_[hash & (kSymbolCacheSize - 1)];
+    if (cached.hash == hash && cached.symbol && symbols_->name(cached.symbol) == name) return cached.symbol;
+    Symbol symbol = symbols_->intern(name, hash);
+    cached = SymbolCacheEntry{hash, symbol};
+    return symbol;
+}
+
+} // namespace MysqlParser
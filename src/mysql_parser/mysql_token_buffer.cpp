@@ -0,0 +1,174 @@
+#include "mysql_parser/mysql_token_buffer.h"
+#include "mysql_parser_internal.h"
+#include "mysql_parser.tab.h" // Token numbers and union MYSQL_YYSTYPE
+#include <climits>
+#include <limits>
+
+struct yy_buffer_state; // Opaque Flex buffer type
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern YY_BUFFER_STATE mysql_yy_scan_bytes(const char *bytes, int len, yyscan_t yyscanner);
+extern void mysql_yy_delete_buffer(YY_BUFFER_STATE b, yyscan_t yyscanner);
+int mysql_yylex_raw(union MYSQL_YYSTYPE* yylval_param, yyscan_t yyscanner, MysqlParser::ParserContext* parser_context); // Flex scanner
+
+namespace MysqlParser {
+
+TokenBuffer::TokenBuffer() = default;
+TokenBuffer::~TokenBuffer() = default;
+
+bool TokenBuffer::lex(const std::string& sql) {
+    return lex(sql.data(), sql.size());
+}
+
+bool TokenBuffer::lex(const char* sql, size_t len) {
+    query_.assign(sql, len); // The scanner reads this copy, so offsets are into query()
+    tokens_.clear();
+    values_.clear();
+    stored_.clear();
+    events_.clear();
+    errors_.clear();
+    comments_.clear();
+    digest_ = 0;
+    if (!lexer_) lexer_.reset(new ParserContext());
+    return lexer_->tokenize(query_.data(), query_.size(), *this);
+}
+
+std::string_view TokenBuffer::value(const Token& t) const {
+    if (!(t.flags & kTokenHasValue)) return std::string_view();
+    if (t.flags & kTokenStored) {
+        const StoredValue& v = stored_[t.value];
+        return std::string_view(values_).substr(v.offset, v.length);
+    }
+    std::string_view source = text(t);
+    return (t.flags & kTokenQuoted) ? source.substr(1, source.size() - 2) : source;
+}
+
+// --- Lexing (ParserContext) ---
+
+bool ParserContext::tokenize(const char* sql_query, size_t sql_len, TokenBuffer& out) {
+    reset_parse_state();
+    // Count the nodes the lexer charges (string literals) against a budget
+    // that never runs out, to tell which ones belong to no token
+    limits_ = ParseLimits();
+    limits_.max_nodes = std::numeric_limits<size_t>::max();
+    limits_active_ = true;
+
+    if (sql_len > static_cast<size_t>(INT_MAX) - 2) {
+        errors_.push_back("MysqlParser: Query too large.");
+    } else if (!ensure_scanner()) {
+        errors_.push_back("MysqlParser: Failed to initialize Flex scanner.");
+    } else if (YY_BUFFER_STATE buffer_state = mysql_yy_scan_bytes(sql_query, static_cast<int>(sql_len), scanner_state_)) {
+        MYSQL_YYSTYPE value;
+        size_t errors_seen = 0, comments_seen = 0, nodes_seen = 0;
+        for (;;) {
+            value.str_val = nullptr;
+            int token = mysql_yylex_raw(&value, scanner_state_, this);
+            uint32_t index = static_cast<uint32_t>(out.tokens_.size());
+            for (; errors_seen < errors_.size(); ++errors_seen) {
+                out.events_.push_back({index, TokenBuffer::EventKind::Error, static_cast<uint32_t>(errors_seen), 0});
+            }
+            if (comments_.comments.size() != comments_seen) {
+                comments_seen = comments_.comments.size();
+                out.events_.push_back({index, TokenBuffer::EventKind::Comments, static_cast<uint32_t>(comments_seen),
+                                       static_cast<uint32_t>(comments_.annotations.size())});
+            }
+            // A string literal's node is charged by the lexer; any other
+            // charge is for a literal that never became a token
+            size_t charged = node_count_ - nodes_seen, own = token == TOKEN_STRING_LITERAL ? 1 : 0;
+            size_t orphans = charged > own ? charged - own : 0;
+            for (size_t i = 0; i < orphans; ++i) out.events_.push_back({index, TokenBuffer::EventKind::Node, 0, 0});
+            nodes_seen = node_count_;
+
+            internal_digest_token(token, token == TOKEN_IDENTIFIER ? value.str_val : nullptr);
+            if (token <= 0) break;
+
+            Token t{static_cast<uint16_t>(token), 0, static_cast<uint32_t>(token_start_),
+                    static_cast<uint32_t>(token_end_ - token_start_), 0};
+            const std::string* v = nullptr;
+            if (token == TOKEN_STRING_LITERAL) {
+                t.flags = kTokenLiteral | kTokenHasValue | (value.node_val->escaped ? kTokenEscaped : 0);
+                v = &value.node_val->value;
+            } else if (token == TOKEN_IDENTIFIER || token == TOKEN_NUMBER_LITERAL || token == TOKEN_QUIT) {
+                t.flags = kTokenHasValue | (token == TOKEN_IDENTIFIER ? kTokenIdentifier : 0) |
+                          (token == TOKEN_NUMBER_LITERAL ? kTokenLiteral : 0);
+                v = value.str_val;
+            }
+            if (v) {
+                // Most values are the source text, or the source text in
+                // quotes; only the others take space in the buffer
+                std::string_view source(sql_query + t.offset, t.length);
+                if (source.size() == v->size() + 2 && source.substr(1, v->size()) == *v) {
+                    t.flags |= kTokenQuoted;
+                } else if (source != *v) {
+                    t.flags |= kTokenStored;
+                    t.value = static_cast<uint32_t>(out.stored_.size());
+                    out.stored_.push_back({static_cast<uint32_t>(out.values_.size()), static_cast<uint32_t>(v->size())});
+                    out.values_ += *v;
+                }
+                if (token == TOKEN_STRING_LITERAL) {
+                    delete value.node_val;
+                } else {
+                    delete value.str_val;
+                }
+            }
+            out.tokens_.push_back(t);
+        }
+        mysql_yy_delete_buffer(buffer_state, scanner_state_);
+    } else {
+        errors_.push_back("MysqlParser: Error setting up scanner buffer for query.");
+    }
+
+    out.errors_.swap(errors_); // Keeps the capacity of both
+    errors_.clear();
+    out.comments_ = comments_;
+    out.digest_ = internal_digest();
+    limits_active_ = false;
+    return out.errors_.empty();
+}
+
+// --- Replay into the grammar (ParserContext) ---
+
+std::unique_ptr<AstNode> ParserContext::parse(const TokenBuffer& tokens, const ParseLimits* limits) {
+    struct ReplayScope {
+        ParserContext* ctx;
+        ~ReplayScope() { ctx->replay_ = nullptr; }
+    } scope{this};
+    replay_ = &tokens;
+    replay_token_ = 0;
+    replay_event_ = 0;
+    return parse(tokens.query_.data(), tokens.query_.size(), limits);
+}
+
+int ParserContext::internal_replay_token(union MYSQL_YYSTYPE* yylval_param) {
+    const TokenBuffer& tokens = *replay_;
+    // What the scanner did while reading this token
+    for (; replay_event_ < tokens.events_.size() && tokens.events_[replay_event_].token <= replay_token_; ++replay_event_) {
+        const TokenBuffer::Event& e = tokens.events_[replay_event_];
+        switch (e.kind) {
+            case TokenBuffer::EventKind::Error:
+                internal_add_error(tokens.errors_[e.count]);
+                break;
+            case TokenBuffer::EventKind::Comments:
+                for (size_t i = comments_.comments.size(); i < e.count; ++i) comments_.comments.push_back(tokens.comments_.comments[i]);
+                for (size_t i = comments_.annotations.size(); i < e.annotations; ++i) comments_.annotations.push_back(tokens.comments_.annotations[i]);
+                break;
+            case TokenBuffer::EventKind::Node:
+                internal_charge_node();
+                break;
+        }
+    }
+    if (replay_token_ == tokens.tokens_.size()) return 0; // End of input
+    const Token& t = tokens.tokens_[replay_token_++];
+    if (t.flags & kTokenHasValue) {
+        std::string_view v = tokens.value(t);
+        if (t.id == TOKEN_STRING_LITERAL) {
+            internal_charge_node();
+            yylval_param->node_val = new AstNode(NodeType::NODE_STRING_LITERAL, std::string(v));
+            yylval_param->node_val->escaped = (t.flags & kTokenEscaped) != 0;
+        } else {
+            yylval_param->str_val = new std::string(v);
+        }
+    }
+    return t.id;
+}
+
+} // namespace MysqlParser
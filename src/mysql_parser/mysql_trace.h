@@ -0,0 +1,45 @@
+#ifndef MYSQL_PARSER_TRACE_H
+#define MYSQL_PARSER_TRACE_H
+
+// Not installed; include only from src/mysql_parser.
+//
+// Static user-space tracepoints (USDT) of the "mysqlparser" provider, for
+// attributing parse time to its phases with bpftrace or perf on a running
+// process (see scripts/). Each probe is a single nop plus an ELF note until a
+// tracer attaches. Arguments are still evaluated, so pass only values already
+// at hand.
+//
+// Built in when <sys/sdt.h> (systemtap-sdt-dev) is available; define
+// MYSQL_PARSER_NO_USDT (make USDT=0) to compile them out.
+//
+// Probes, in the order a parse fires them:
+//   parse_start(query, length)         ParserContext::parse() entered
+//   fast_path_start, fast_path_done(hit)
+//   buffer_setup_start, buffer_setup_done
+//   lex_start, lex_done(token)         Around each Flex scanner call
+//   node_new                           Each grammar node, charged or not
+//   statement(kind, node_type)         A complete statement reduced
+//   grammar_done(result)               mysql_yyparse() returned
+//   buffer_teardown_done
+//   parse_error(status, message)       Failed parse, with its last error
+//   parse_done(status, tree)           tree is 1 if a tree is returned
+//   teardown_start, teardown_done      ~AstNode() freeing a tree's nodes
+
+#if !defined(MYSQL_PARSER_NO_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define MYSQL_PARSER_USDT 1
+#endif
+#endif
+
+#ifdef MYSQL_PARSER_USDT
+#define MYSQL_TRACE(probe) DTRACE_PROBE(mysqlparser, probe)
+#define MYSQL_TRACE1(probe, a) DTRACE_PROBE1(mysqlparser, probe, a)
+#define MYSQL_TRACE2(probe, a, b) DTRACE_PROBE2(mysqlparser, probe, a, b)
+#else
+#define MYSQL_TRACE(probe) do { } while (0)
+#define MYSQL_TRACE1(probe, a) do { } while (0)
+#define MYSQL_TRACE2(probe, a, b) do { } while (0)
+#endif
+
+#endif // MYSQL_PARSER_TRACE_H
@@ -1,4 +1,5 @@
 #include "pgsql_parser/pgsql_parser.h"
+#include "pgsql_trace.h"
 #include <stdexcept>
 
 // yyscan_t is defined as typedef void* yyscan_t; in pgsql_parser.h
@@ -48,31 +49,45 @@ const std::vector<std::string>& Parser::getErrors() const {
 }
 
 std::unique_ptr<AstNode> Parser::parse(const std::string& sql_query) {
+    PGSQL_TRACE2(parse_start, sql_query.c_str(), sql_query.size());
     clearErrors();
     ast_root_.reset(); 
+    invalid_utf8_end_ = SIZE_MAX;
 
     if (!scanner_state_) {
         errors_.push_back("PgsqlParser: Scanner not initialized.");
+        PGSQL_TRACE1(parse_error, errors_.back().c_str());
+        PGSQL_TRACE1(parse_done, 0);
         return nullptr;
     }
 
+    PGSQL_TRACE(buffer_setup_start);
     YY_BUFFER_STATE buffer_state = pgsql_yy_scan_string(sql_query.c_str(), scanner_state_);
+    PGSQL_TRACE(buffer_setup_done);
     if (!buffer_state) {
         errors_.push_back("PgsqlParser: Error setting up scanner buffer for query.");
+        PGSQL_TRACE1(parse_error, errors_.back().c_str());
+        PGSQL_TRACE1(parse_done, 0);
         return nullptr;
     }
 
     int parse_result = pgsql_yyparse(scanner_state_, this);
+    PGSQL_TRACE1(grammar_done, parse_result);
 
     pgsql_yy_delete_buffer(buffer_state, scanner_state_);
+    PGSQL_TRACE(buffer_teardown_done);
 
     if (parse_result == 0) { 
+        PGSQL_TRACE1(parse_done, ast_root_ ? 1 : 0);
         return std::move(ast_root_); 
     }
+    PGSQL_TRACE1(parse_error, errors_.empty() ? "" : errors_.back().c_str());
+    PGSQL_TRACE1(parse_done, 0);
     return nullptr;
 }
 
 void Parser::internal_set_ast(AstNode* root) {
+    PGSQL_TRACE1(statement, root ? static_cast<int>(root->type) : -1);
     ast_root_.reset(root);
 }
 
@@ -84,6 +99,13 @@ void Parser::internal_add_error_at(const std::string& msg, int line, int column)
     errors_.push_back("Line " + std::to_string(line) + ", Col " + std::to_string(column) + ": " + msg);
 }
 
+void Parser::internal_invalid_utf8_byte(size_t offset) {
+    if (offset != invalid_utf8_end_) {
+        errors_.push_back("Lexer: Invalid UTF-8 sequence at offset " + std::to_string(offset));
+    }
+    invalid_utf8_end_ = offset + 1;
+}
+
 } // namespace PgsqlParser
 
 
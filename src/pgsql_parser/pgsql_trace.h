@@ -0,0 +1,37 @@
+#ifndef PGSQL_PARSER_TRACE_H
+#define PGSQL_PARSER_TRACE_H
+
+// Not installed; include only from src/pgsql_parser.
+//
+// Static user-space tracepoints (USDT) of the "pgsqlparser" provider; see
+// src/mysql_parser/mysql_trace.h, whose phases these mirror. Built in when
+// <sys/sdt.h> is available; define PGSQL_PARSER_NO_USDT (make USDT=0) to
+// compile them out.
+//
+// Probes, in the order a parse fires them:
+//   parse_start(query, length)
+//   buffer_setup_start, buffer_setup_done
+//   statement(node_type)               A complete statement reduced
+//   grammar_done(result)
+//   buffer_teardown_done
+//   parse_error(message)               Failed parse, with its last error
+//   parse_done(tree)                   tree is 1 if a tree is returned
+
+#if !defined(PGSQL_PARSER_NO_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define PGSQL_PARSER_USDT 1
+#endif
+#endif
+
+#ifdef PGSQL_PARSER_USDT
+#define PGSQL_TRACE(probe) DTRACE_PROBE(pgsqlparser, probe)
+#define PGSQL_TRACE1(probe, a) DTRACE_PROBE1(pgsqlparser, probe, a)
+#define PGSQL_TRACE2(probe, a, b) DTRACE_PROBE2(pgsqlparser, probe, a, b)
+#else
+#define PGSQL_TRACE(probe) do { } while (0)
+#define PGSQL_TRACE1(probe, a) do { } while (0)
+#define PGSQL_TRACE2(probe, a, b) do { } while (0)
+#endif
+
+#endif // PGSQL_PARSER_TRACE_H